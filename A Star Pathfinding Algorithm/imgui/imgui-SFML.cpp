@@ -10,8 +10,10 @@
 #include <SFML/Graphics/Texture.hpp>
 #include <SFML/OpenGL.hpp>
 #include <SFML/Window/Clipboard.hpp>
+#include <SFML/Window/Context.hpp>
 #include <SFML/Window/Cursor.hpp>
 #include <SFML/Window/Event.hpp>
+#include <SFML/Window/GlResource.hpp>
 #include <SFML/Window/Touch.hpp>
 #include <SFML/Window/Window.hpp>
 
@@ -113,6 +115,22 @@ static_assert(sizeof(GLuint) <= sizeof(ImTextureID),
               "ImTextureID is not large enough to fit GLuint.");
 #endif
 
+// OpenGL 1.5 / 2.0 names missing from OpenGL 1.1 headers (Windows), used by the shader renderer
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+#ifndef GL_ARRAY_BUFFER
+#define GL_ARRAY_BUFFER 0x8892
+#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#define GL_STREAM_DRAW 0x88E0
+#endif
+#ifndef GL_FRAGMENT_SHADER
+#define GL_FRAGMENT_SHADER 0x8B30
+#define GL_VERTEX_SHADER 0x8B31
+#define GL_COMPILE_STATUS 0x8B81
+#define GL_LINK_STATUS 0x8B82
+#endif
+
 namespace {
 // various helper functions
 ImColor toImColor(sf::Color c);
@@ -124,6 +142,56 @@ GLuint convertImTextureIDToGLTextureHandle(ImTextureID textureID);
 
 void RenderDrawLists(ImDrawData* draw_data); // rendering callback function prototype
 
+// Streaming vertex/index buffers and a small shader (OpenGL 2.0), instead of the fixed-function
+// client-side arrays of RenderDrawLists. Sets every piece of GL state it draws with and reads
+// none back: SFML's own states are re-applied with resetGLStates() afterwards.
+// A GlResource like sf::Texture, so its program and buffers can be freed after the window (and
+// its context) is gone.
+struct ShaderRenderer : sf::GlResource {
+    // not exported by every platform's OpenGL library, loaded through SFML
+    struct Functions {
+        void(APIENTRY* genBuffers)(GLsizei, GLuint*);
+        void(APIENTRY* deleteBuffers)(GLsizei, const GLuint*);
+        void(APIENTRY* bindBuffer)(GLenum, GLuint);
+        void(APIENTRY* bufferData)(GLenum, std::ptrdiff_t, const void*, GLenum);
+        void(APIENTRY* bufferSubData)(GLenum, std::ptrdiff_t, std::ptrdiff_t, const void*);
+        GLuint(APIENTRY* createShader)(GLenum);
+        void(APIENTRY* shaderSource)(GLuint, GLsizei, const char* const*, const GLint*);
+        void(APIENTRY* compileShader)(GLuint);
+        void(APIENTRY* getShaderiv)(GLuint, GLenum, GLint*);
+        void(APIENTRY* deleteShader)(GLuint);
+        GLuint(APIENTRY* createProgram)();
+        void(APIENTRY* attachShader)(GLuint, GLuint);
+        void(APIENTRY* bindAttribLocation)(GLuint, GLuint, const char*);
+        void(APIENTRY* linkProgram)(GLuint);
+        void(APIENTRY* getProgramiv)(GLuint, GLenum, GLint*);
+        void(APIENTRY* deleteProgram)(GLuint);
+        void(APIENTRY* useProgram)(GLuint);
+        GLint(APIENTRY* getUniformLocation)(GLuint, const char*);
+        void(APIENTRY* uniform1i)(GLint, GLint);
+        void(APIENTRY* uniformMatrix4fv)(GLint, GLsizei, GLboolean, const GLfloat*);
+        void(APIENTRY* enableVertexAttribArray)(GLuint);
+        void(APIENTRY* disableVertexAttribArray)(GLuint);
+        void(APIENTRY* vertexAttribPointer)(GLuint, GLint, GLenum, GLboolean, GLsizei, const void*);
+    } gl;
+
+    GLuint program;
+    GLint projectionLocation;
+    GLuint vertexBuffer;
+    GLuint indexBuffer;
+    std::ptrdiff_t vertexCapacity; // bytes, buffers only ever grow
+    std::ptrdiff_t indexCapacity;
+
+    ShaderRenderer();
+    ~ShaderRenderer();
+
+    // false if the current context lacks buffers or shaders
+    bool init();
+    void render(ImDrawData* draw_data);
+    void setupRenderState(ImDrawData* draw_data, int fb_width, int fb_height);
+    void setVertexPointers(std::ptrdiff_t offset); // ImDrawVert layout from offset on
+};
+
 // Default mapping is XInput gamepad mapping
 void initDefaultJoystickMapping();
 
@@ -201,6 +269,8 @@ struct WindowContext {
     sf::Cursor mouseCursors[ImGuiMouseCursor_COUNT];
     bool mouseCursorLoaded[ImGuiMouseCursor_COUNT];
 
+    std::unique_ptr<ShaderRenderer> shaderRenderer; // null: fixed-function RenderDrawLists
+
 #ifdef ANDROID
 #ifdef USE_JNI
     bool wantTextInput;
@@ -728,6 +798,15 @@ void Render(sf::RenderWindow& window) {
 }
 
 void Render(sf::RenderTarget& target) {
+    if (s_currWindowCtx->shaderRenderer) {
+        // no push/pop of GL state, SFML's cached states are simply set again afterwards
+        ImGui::Render();
+        target.setActive(true);
+        s_currWindowCtx->shaderRenderer->render(ImGui::GetDrawData());
+        target.resetGLStates();
+        return;
+    }
+
     target.resetGLStates();
     target.pushGLStates();
     ImGui::Render();
@@ -807,6 +886,29 @@ sf::Texture& GetFontTexture() {
     return s_currWindowCtx->fontTexture;
 }
 
+bool SetShaderRendering(bool enabled) {
+    assert(s_currWindowCtx);
+    if (!enabled) {
+        s_currWindowCtx->shaderRenderer.reset();
+        return true;
+    }
+    if (s_currWindowCtx->shaderRenderer) {
+        return true;
+    }
+
+    std::unique_ptr<ShaderRenderer> renderer(new ShaderRenderer());
+    if (!renderer->init()) {
+        return false;
+    }
+    s_currWindowCtx->shaderRenderer = std::move(renderer);
+    return true;
+}
+
+bool IsShaderRendering() {
+    assert(s_currWindowCtx);
+    return s_currWindowCtx->shaderRenderer != nullptr;
+}
+
 void SetActiveJoystickId(unsigned int joystickId) {
     assert(s_currWindowCtx);
     assert(joystickId < sf::Joystick::Count);
@@ -1267,6 +1369,267 @@ void RenderDrawLists(ImDrawData* draw_data) {
 #endif
 }
 
+template<typename T>
+bool loadGLFunction(T& function, const char* name) {
+    function = reinterpret_cast<T>(sf::Context::getFunction(name));
+    return function != NULL;
+}
+
+const char* const shaderVertexSource = "#version 110\n"
+                                       "uniform mat4 projection;\n"
+                                       "attribute vec2 position;\n"
+                                       "attribute vec2 uv;\n"
+                                       "attribute vec4 color;\n"
+                                       "varying vec2 fragmentUv;\n"
+                                       "varying vec4 fragmentColor;\n"
+                                       "void main() {\n"
+                                       "    fragmentUv = uv;\n"
+                                       "    fragmentColor = color;\n"
+                                       "    gl_Position = projection * vec4(position, 0.0, 1.0);\n"
+                                       "}\n";
+
+const char* const shaderFragmentSource = "#version 110\n"
+                                         "uniform sampler2D atlas;\n"
+                                         "varying vec2 fragmentUv;\n"
+                                         "varying vec4 fragmentColor;\n"
+                                         "void main() {\n"
+                                         "    gl_FragColor = fragmentColor * texture2D(atlas, fragmentUv);\n"
+                                         "}\n";
+
+// attribute locations, bound before linking
+const GLuint ATTRIB_POSITION = 0;
+const GLuint ATTRIB_UV = 1;
+const GLuint ATTRIB_COLOR = 2;
+
+ShaderRenderer::ShaderRenderer()
+    : gl(), program(0), projectionLocation(-1), vertexBuffer(0), indexBuffer(0), vertexCapacity(0),
+      indexCapacity(0) {}
+
+ShaderRenderer::~ShaderRenderer() {
+    // Shutdown() usually runs after window.close(), borrow a context to free them in
+    TransientContextLock lock;
+    if (program) gl.deleteProgram(program);
+    if (vertexBuffer) gl.deleteBuffers(1, &vertexBuffer);
+    if (indexBuffer) gl.deleteBuffers(1, &indexBuffer);
+}
+
+bool ShaderRenderer::init() {
+    bool loaded = loadGLFunction(gl.genBuffers, "glGenBuffers") &&
+                  loadGLFunction(gl.deleteBuffers, "glDeleteBuffers") &&
+                  loadGLFunction(gl.bindBuffer, "glBindBuffer") &&
+                  loadGLFunction(gl.bufferData, "glBufferData") &&
+                  loadGLFunction(gl.bufferSubData, "glBufferSubData") &&
+                  loadGLFunction(gl.createShader, "glCreateShader") &&
+                  loadGLFunction(gl.shaderSource, "glShaderSource") &&
+                  loadGLFunction(gl.compileShader, "glCompileShader") &&
+                  loadGLFunction(gl.getShaderiv, "glGetShaderiv") &&
+                  loadGLFunction(gl.deleteShader, "glDeleteShader") &&
+                  loadGLFunction(gl.createProgram, "glCreateProgram") &&
+                  loadGLFunction(gl.attachShader, "glAttachShader") &&
+                  loadGLFunction(gl.bindAttribLocation, "glBindAttribLocation") &&
+                  loadGLFunction(gl.linkProgram, "glLinkProgram") &&
+                  loadGLFunction(gl.getProgramiv, "glGetProgramiv") &&
+                  loadGLFunction(gl.deleteProgram, "glDeleteProgram") &&
+                  loadGLFunction(gl.useProgram, "glUseProgram") &&
+                  loadGLFunction(gl.getUniformLocation, "glGetUniformLocation") &&
+                  loadGLFunction(gl.uniform1i, "glUniform1i") &&
+                  loadGLFunction(gl.uniformMatrix4fv, "glUniformMatrix4fv") &&
+                  loadGLFunction(gl.enableVertexAttribArray, "glEnableVertexAttribArray") &&
+                  loadGLFunction(gl.disableVertexAttribArray, "glDisableVertexAttribArray") &&
+                  loadGLFunction(gl.vertexAttribPointer, "glVertexAttribPointer");
+    if (!loaded) {
+        return false;
+    }
+
+    GLuint vertexShader = gl.createShader(GL_VERTEX_SHADER);
+    GLuint fragmentShader = gl.createShader(GL_FRAGMENT_SHADER);
+    gl.shaderSource(vertexShader, 1, &shaderVertexSource, NULL);
+    gl.shaderSource(fragmentShader, 1, &shaderFragmentSource, NULL);
+    gl.compileShader(vertexShader);
+    gl.compileShader(fragmentShader);
+
+    program = gl.createProgram();
+    gl.attachShader(program, vertexShader);
+    gl.attachShader(program, fragmentShader);
+    gl.bindAttribLocation(program, ATTRIB_POSITION, "position");
+    gl.bindAttribLocation(program, ATTRIB_UV, "uv");
+    gl.bindAttribLocation(program, ATTRIB_COLOR, "color");
+    gl.linkProgram(program);
+
+    // the program keeps what it needs, the shaders go once it's linked
+    GLint vertexCompiled = GL_FALSE, fragmentCompiled = GL_FALSE, linked = GL_FALSE;
+    gl.getShaderiv(vertexShader, GL_COMPILE_STATUS, &vertexCompiled);
+    gl.getShaderiv(fragmentShader, GL_COMPILE_STATUS, &fragmentCompiled);
+    gl.getProgramiv(program, GL_LINK_STATUS, &linked);
+    gl.deleteShader(vertexShader);
+    gl.deleteShader(fragmentShader);
+    if (!vertexCompiled || !fragmentCompiled || !linked) {
+        return false;
+    }
+
+    // the atlas sampler never changes, set once
+    projectionLocation = gl.getUniformLocation(program, "projection");
+    gl.useProgram(program);
+    gl.uniform1i(gl.getUniformLocation(program, "atlas"), 0);
+    gl.useProgram(0);
+
+    gl.genBuffers(1, &vertexBuffer);
+    gl.genBuffers(1, &indexBuffer);
+    return true;
+}
+
+// based on imgui/backends/imgui_impl_opengl3.cpp, OpenGL 2.0 subset
+void ShaderRenderer::setupRenderState(ImDrawData* draw_data, int fb_width, int fb_height) {
+    // Setup render state: alpha-blending enabled, no face culling, no depth testing, scissor
+    // enabled. SFML leaves its client-side arrays enabled, they're switched off so only the
+    // buffers are read.
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_STENCIL_TEST);
+    glEnable(GL_SCISSOR_TEST);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glViewport(0, 0, (GLsizei)fb_width, (GLsizei)fb_height);
+
+    // Orthographic projection from draw_data->DisplayPos (top left) to
+    // draw_data->DisplayPos+data_data->DisplaySize (bottom right)
+    float L = draw_data->DisplayPos.x;
+    float R = draw_data->DisplayPos.x + draw_data->DisplaySize.x;
+    float T = draw_data->DisplayPos.y;
+    float B = draw_data->DisplayPos.y + draw_data->DisplaySize.y;
+    const GLfloat ortho_projection[4][4] = {
+        {2.0f / (R - L), 0.0f, 0.0f, 0.0f},
+        {0.0f, 2.0f / (T - B), 0.0f, 0.0f},
+        {0.0f, 0.0f, -1.0f, 0.0f},
+        {(R + L) / (L - R), (T + B) / (B - T), 0.0f, 1.0f},
+    };
+    gl.useProgram(program);
+    gl.uniformMatrix4fv(projectionLocation, 1, GL_FALSE, &ortho_projection[0][0]);
+
+    gl.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    gl.enableVertexAttribArray(ATTRIB_POSITION);
+    gl.enableVertexAttribArray(ATTRIB_UV);
+    gl.enableVertexAttribArray(ATTRIB_COLOR);
+}
+
+void ShaderRenderer::setVertexPointers(std::ptrdiff_t offset) {
+    gl.vertexAttribPointer(ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert),
+                           (const GLvoid*)(offset + IM_OFFSETOF(ImDrawVert, pos)));
+    gl.vertexAttribPointer(ATTRIB_UV, 2, GL_FLOAT, GL_FALSE, sizeof(ImDrawVert),
+                           (const GLvoid*)(offset + IM_OFFSETOF(ImDrawVert, uv)));
+    gl.vertexAttribPointer(ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(ImDrawVert),
+                           (const GLvoid*)(offset + IM_OFFSETOF(ImDrawVert, col)));
+}
+
+void ShaderRenderer::render(ImDrawData* draw_data) {
+    if (draw_data->CmdListsCount == 0) {
+        return;
+    }
+
+    ImGuiIO& io = ImGui::GetIO();
+    assert(io.Fonts->TexID != (ImTextureID)NULL); // You forgot to create and set font texture
+
+    int fb_width = (int)(draw_data->DisplaySize.x * draw_data->FramebufferScale.x);
+    int fb_height = (int)(draw_data->DisplaySize.y * draw_data->FramebufferScale.y);
+    if (fb_width == 0 || fb_height == 0) return;
+    draw_data->ScaleClipRects(io.DisplayFramebufferScale);
+
+    setupRenderState(draw_data, fb_width, fb_height);
+
+    // Whole frame in one upload per buffer. Re-specifying the storage orphans last frame's copy, so
+    // the driver never waits for the GPU to finish with it. Capacity only grows.
+    std::ptrdiff_t vertexBytes = (std::ptrdiff_t)draw_data->TotalVtxCount * sizeof(ImDrawVert);
+    std::ptrdiff_t indexBytes = (std::ptrdiff_t)draw_data->TotalIdxCount * sizeof(ImDrawIdx);
+    vertexCapacity = std::max(vertexCapacity, vertexBytes);
+    indexCapacity = std::max(indexCapacity, indexBytes);
+    gl.bufferData(GL_ARRAY_BUFFER, vertexCapacity, NULL, GL_STREAM_DRAW);
+    gl.bufferData(GL_ELEMENT_ARRAY_BUFFER, indexCapacity, NULL, GL_STREAM_DRAW);
+
+    std::ptrdiff_t vertexOffset = 0;
+    std::ptrdiff_t indexOffset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+        std::ptrdiff_t listVertexBytes = (std::ptrdiff_t)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+        std::ptrdiff_t listIndexBytes = (std::ptrdiff_t)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+        gl.bufferSubData(GL_ARRAY_BUFFER, vertexOffset, listVertexBytes, cmd_list->VtxBuffer.Data);
+        gl.bufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset, listIndexBytes, cmd_list->IdxBuffer.Data);
+        vertexOffset += listVertexBytes;
+        indexOffset += listIndexBytes;
+    }
+
+    // Will project scissor/clipping rectangles into framebuffer space
+    ImVec2 clip_off = draw_data->DisplayPos; // (0,0) unless using multi-viewports
+    ImVec2 clip_scale = draw_data->FramebufferScale; // (1,1) unless using retina display which are
+                                                     // often (2,2)
+
+    // Render command lists, the bound texture is remembered instead of queried
+    GLuint boundTexture = 0;
+    glBindTexture(GL_TEXTURE_2D, 0);
+    vertexOffset = 0;
+    indexOffset = 0;
+    for (int n = 0; n < draw_data->CmdListsCount; n++) {
+        const ImDrawList* cmd_list = draw_data->CmdLists[n];
+
+        // indices are per list, so each list's vertices are pointed at separately
+        setVertexPointers(vertexOffset);
+
+        for (int cmd_i = 0; cmd_i < cmd_list->CmdBuffer.Size; cmd_i++) {
+            const ImDrawCmd* pcmd = &cmd_list->CmdBuffer[cmd_i];
+            if (pcmd->UserCallback) {
+                // User callback, registered via ImDrawList::AddCallback()
+                // (ImDrawCallback_ResetRenderState is a special callback value used by the user to
+                // request the renderer to reset render state.)
+                if (pcmd->UserCallback == ImDrawCallback_ResetRenderState) {
+                    setupRenderState(draw_data, fb_width, fb_height);
+                    setVertexPointers(vertexOffset);
+                    glBindTexture(GL_TEXTURE_2D, boundTexture);
+                } else
+                    pcmd->UserCallback(cmd_list, pcmd);
+            } else {
+                // Project scissor/clipping rectangles into framebuffer space
+                ImVec4 clip_rect;
+                clip_rect.x = (pcmd->ClipRect.x - clip_off.x) * clip_scale.x;
+                clip_rect.y = (pcmd->ClipRect.y - clip_off.y) * clip_scale.y;
+                clip_rect.z = (pcmd->ClipRect.z - clip_off.x) * clip_scale.x;
+                clip_rect.w = (pcmd->ClipRect.w - clip_off.y) * clip_scale.y;
+
+                if (clip_rect.x < fb_width && clip_rect.y < fb_height && clip_rect.z >= 0.0f &&
+                    clip_rect.w >= 0.0f) {
+                    // Apply scissor/clipping rectangle
+                    glScissor((int)clip_rect.x, (int)(fb_height - clip_rect.w),
+                              (int)(clip_rect.z - clip_rect.x), (int)(clip_rect.w - clip_rect.y));
+
+                    // Bind texture if it changed, Draw
+                    GLuint textureHandle = convertImTextureIDToGLTextureHandle(pcmd->TextureId);
+                    if (textureHandle != boundTexture) {
+                        glBindTexture(GL_TEXTURE_2D, textureHandle);
+                        boundTexture = textureHandle;
+                    }
+                    glDrawElements(GL_TRIANGLES, (GLsizei)pcmd->ElemCount,
+                                   sizeof(ImDrawIdx) == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT,
+                                   (const GLvoid*)(indexOffset + pcmd->IdxOffset * sizeof(ImDrawIdx)));
+                }
+            }
+        }
+        vertexOffset += (std::ptrdiff_t)cmd_list->VtxBuffer.Size * sizeof(ImDrawVert);
+        indexOffset += (std::ptrdiff_t)cmd_list->IdxBuffer.Size * sizeof(ImDrawIdx);
+    }
+
+    // Undo what resetGLStates() doesn't: SFML never uses scissoring, index buffers or generic
+    // vertex attributes
+    gl.disableVertexAttribArray(ATTRIB_POSITION);
+    gl.disableVertexAttribArray(ATTRIB_UV);
+    gl.disableVertexAttribArray(ATTRIB_COLOR);
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    gl.bindBuffer(GL_ARRAY_BUFFER, 0);
+    gl.useProgram(0);
+    glDisable(GL_SCISSOR_TEST);
+}
+
 unsigned int getConnectedJoystickId() {
     for (unsigned int i = 0; i < (unsigned int)sf::Joystick::Count; ++i) {
         if (sf::Joystick::isConnected(i)) return i;
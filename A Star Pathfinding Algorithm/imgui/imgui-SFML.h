@@ -55,6 +55,12 @@ IMGUI_SFML_API void Shutdown();
 IMGUI_SFML_NODISCARD IMGUI_SFML_API bool UpdateFontTexture();
 IMGUI_SFML_API sf::Texture& GetFontTexture();
 
+// Draw with streaming vertex/index buffers and a small shader (OpenGL 2.0) instead of
+// fixed-function client-side arrays, without reading GL state back every frame. Returns false and
+// keeps the fixed-function path if the current context can't provide them.
+IMGUI_SFML_NODISCARD IMGUI_SFML_API bool SetShaderRendering(bool enabled);
+IMGUI_SFML_API bool IsShaderRendering();
+
 // joystick functions
 IMGUI_SFML_API void SetActiveJoystickId(unsigned int joystickId);
 IMGUI_SFML_API void SetJoystickDPadThreshold(float threshold);
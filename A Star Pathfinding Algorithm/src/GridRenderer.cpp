@@ -0,0 +1,196 @@
+#include "GridRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // cells built + uploaded per update() call:
+    const int CHUNK_CELLS = 16384;
+
+    // changed cells this close together go up as one run, the clean ones between included:
+    const int RUN_GAP = 8;
+
+    // outlines on smaller tiles would only be noise:
+    const float MIN_OUTLINED_PIXELS = 8.f;
+}
+
+bool GridRenderer::Window::operator==(const Window& other) const
+{
+    return left == other.left && top == other.top && right == other.right && bottom == other.bottom;
+}
+
+GridRenderer::GridRenderer()
+    : outlines(sf::Quads, sf::VertexBuffer::Dynamic),
+    tiles(sf::Quads, sf::VertexBuffer::Dynamic)
+{
+}
+
+void GridRenderer::Quad(sf::Vertex* quad, sf::Vector2f topLeft, sf::Vector2f bottomRight, sf::Color colour)
+{
+    quad[0] = sf::Vertex(topLeft, colour);
+    quad[1] = sf::Vertex(sf::Vector2f(bottomRight.x, topLeft.y), colour);
+    quad[2] = sf::Vertex(bottomRight, colour);
+    quad[3] = sf::Vertex(sf::Vector2f(topLeft.x, bottomRight.y), colour);
+}
+
+bool GridRenderer::Reserve(sf::VertexBuffer& buffer, std::size_t count)
+{
+    // grows only, a smaller window draws from the front:
+    return buffer.getVertexCount() >= count || buffer.create(count);
+}
+
+void GridRenderer::Layout(int width, int height, sf::Vector2f offset, float pitch, float size, float outline, sf::Color background)
+{
+    this->width = width;
+    this->height = height;
+    this->offset = offset;
+    this->pitch = pitch;
+    this->size = size;
+    this->outline = outline;
+    this->background = background;
+
+    // nothing in view until the next Cull():
+    visible = Window();
+    colours.clear();
+    dirty.clear();
+    outlineVertices = 0;
+}
+
+bool GridRenderer::Cull(const sf::View& view)
+{
+    // every tile overlapping the view rectangle, straight from its bounds:
+    sf::Vector2f topLeft = view.getCenter() - view.getSize() / 2.f;
+    sf::Vector2f bottomRight = view.getCenter() + view.getSize() / 2.f;
+    float reach = size / 2 + outline;
+
+    auto first = [&](float edge, int count)
+    {
+        return std::clamp(static_cast<int>(std::ceil((edge - reach) / pitch)), 0, count);
+    };
+    auto last = [&](float edge, int count)
+    {
+        return std::clamp(static_cast<int>(std::floor((edge + reach) / pitch)) + 1, 0, count);
+    };
+
+    Window next;
+    next.left = first(topLeft.x - offset.x, width);
+    next.top = first(topLeft.y - offset.y, height);
+    next.right = std::max(next.left, last(bottomRight.x - offset.x, width));
+    next.bottom = std::max(next.top, last(bottomRight.y - offset.y, height));
+
+    if (next == visible && !colours.empty())
+        return true;
+
+    // other tiles under every slot, all of them go up again:
+    visible = next;
+    std::size_t count = static_cast<std::size_t>(visible.Width()) * visible.Height();
+    colours.assign(count, sf::Color::Transparent);
+    dirty.clear();
+    moved = true;
+
+    BuildOutlines();
+    return Reserve(tiles, 4 * count);
+}
+
+void GridRenderer::BuildOutlines()
+{
+    outlineVertices = 0;
+    if (outline <= 0.f || visible.Width() == 0 || visible.Height() == 0)
+        return;
+
+    float half = size / 2 + outline;
+    float left = offset.x + pitch * visible.left - half;
+    float right = offset.x + pitch * (visible.right - 1) + half;
+    float top = offset.y + pitch * visible.top - half;
+    float bottom = offset.y + pitch * (visible.bottom - 1) + half;
+
+    // black under each row of tiles:
+    chunk.clear();
+    for (int y = visible.top; y < visible.bottom; y++)
+    {
+        float centre = offset.y + pitch * y;
+        chunk.resize(chunk.size() + 4);
+        Quad(&chunk[chunk.size() - 4], { left, centre - half }, { right, centre + half }, sf::Color::Black);
+    }
+
+    // background between columns, drawn after the bands in the same call:
+    if (pitch > 2 * half)
+    {
+        for (int x = visible.left; x + 1 < visible.right; x++)
+        {
+            float centre = offset.x + pitch * x;
+            chunk.resize(chunk.size() + 4);
+            Quad(&chunk[chunk.size() - 4], { centre + half, top }, { centre + pitch - half, bottom }, background);
+        }
+    }
+
+    if (Reserve(outlines, chunk.size()) && outlines.update(chunk.data(), chunk.size(), 0))
+        outlineVertices = chunk.size();
+}
+
+void GridRenderer::Upload()
+{
+    uploadedCells = 0;
+    uploadRuns = 0;
+
+    // a moved window has no tile in common with the buffer:
+    if (moved)
+    {
+        dirty.clear();
+        UploadRange(0, static_cast<int>(colours.size()));
+        uploadedCells = colours.size();
+        uploadRuns = 1;
+        moved = false;
+        return;
+    }
+
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+
+    for (std::size_t i = 0; i < dirty.size();)
+    {
+        int first = dirty[i];
+        int last = first;
+        while (++i < dirty.size() && dirty[i] - last <= RUN_GAP)
+            last = dirty[i];
+
+        UploadRange(first, last + 1);
+        uploadedCells += static_cast<std::size_t>(last + 1 - first);
+        uploadRuns++;
+    }
+    dirty.clear();
+}
+
+void GridRenderer::UploadRange(int first, int last)
+{
+    float half = size / 2;
+    int columns = visible.Width();
+
+    for (; first < last; first += CHUNK_CELLS)
+    {
+        int count = std::min(CHUNK_CELLS, last - first);
+        chunk.resize(4 * static_cast<std::size_t>(count));
+
+        for (int i = 0; i < count; i++)
+        {
+            int slot = first + i;
+            int x = visible.left + slot % columns;
+            int y = visible.top + slot / columns;
+            sf::Vector2f centre(offset.x + pitch * x, offset.y + pitch * y);
+            Quad(&chunk[4 * i], { centre.x - half, centre.y - half }, { centre.x + half, centre.y + half }, colours[slot]);
+        }
+
+        tiles.update(chunk.data(), chunk.size(), 4 * static_cast<unsigned int>(first));
+    }
+}
+
+void GridRenderer::Draw(sf::RenderTarget& target) const
+{
+    // screen pixels per tile under the target's current view:
+    float pixels = pitch * target.getSize().x / target.getView().getSize().x;
+    if (outlineVertices > 0 && pixels >= MIN_OUTLINED_PIXELS)
+        target.draw(outlines, 0, outlineVertices);
+
+    target.draw(tiles, 0, colours.size() * 4);
+}
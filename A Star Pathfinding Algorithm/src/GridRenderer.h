@@ -0,0 +1,103 @@
+#pragma once
+
+#include "SFML/Graphics.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/* Grid in two draw calls, instead of one per tile (two with an outline):
+ * outlines are a few quads, a black band along each row cut apart by a
+ * background coloured gap between columns, then every tile is one quad
+ * of a vertex buffer, four vertices per tile.
+ *
+ * the buffers only ever hold the tiles in view: Cull() works out which
+ * tiles the view can see from its bounds alone, so a frame costs the
+ * same on any size of map. while the view stays put the tile buffer
+ * stays on the GPU, SetColour() only marks tiles whose colour really
+ * changed and Upload() sends just those, merged into runs of
+ * neighbouring tiles. vertices are built a chunk at a time, there's no
+ * CPU copy of the buffer.
+ */
+class GridRenderer
+{
+public:
+    // tiles in view, [left, right) x [top, bottom):
+    struct Window
+    {
+        int left = 0;
+        int top = 0;
+        int right = 0;
+        int bottom = 0;
+
+        int Width() const { return right - left; }
+        int Height() const { return bottom - top; }
+        bool operator==(const Window& other) const;
+    };
+
+    GridRenderer();
+
+    // centre of tile (x, y) at offset + pitch * (x, y), tiles size wide plus outline on every side:
+    void Layout(int width, int height, sf::Vector2f offset, float pitch, float size, float outline, sf::Color background);
+
+    /* moves the buffers onto the tiles view can see, every tile in view
+     * has to be coloured again afterwards. false if the buffers couldn't
+     * be created.
+     */
+    bool Cull(const sf::View& view);
+    const Window& Visible() const { return visible; }
+
+    // tile (x, y) must be in view:
+    void SetColour(int x, int y, sf::Color colour)
+    {
+        int slot = (x - visible.left) + visible.Width() * (y - visible.top);
+        if (colours[slot] == colour)
+            return;
+        colours[slot] = colour;
+        dirty.push_back(slot);
+    }
+
+    // changed tiles -> vertex buffer:
+    void Upload();
+
+    // outlines only once tiles are big enough on screen to show them:
+    void Draw(sf::RenderTarget& target) const;
+
+    // sent by the last Upload():
+    std::size_t UploadedCells() const { return uploadedCells; }
+    std::size_t UploadRuns() const { return uploadRuns; }
+    std::size_t UploadedBytes() const { return uploadedCells * 4 * sizeof(sf::Vertex); }
+
+private:
+    // corners of a quad, clockwise from top-left:
+    static void Quad(sf::Vertex* quad, sf::Vector2f topLeft, sf::Vector2f bottomRight, sf::Color colour);
+
+    // buffer holds at least count vertices:
+    static bool Reserve(sf::VertexBuffer& buffer, std::size_t count);
+
+    void BuildOutlines();
+
+    // rebuilds + sends tiles in slots [first, last):
+    void UploadRange(int first, int last);
+
+    int width = 0;
+    int height = 0;
+    sf::Vector2f offset;
+    float pitch = 0.f;
+    float size = 0.f;
+    float outline = 0.f;
+    sf::Color background;
+
+    Window visible;
+    bool moved = false;                 // whole window goes up on the next Upload()
+
+    std::vector<sf::Color> colours;     // per tile in view, row by row, as last set
+    std::vector<int> dirty;             // slots changed since the last Upload()
+    std::vector<sf::Vertex> chunk;      // vertices on their way to the GPU
+
+    sf::VertexBuffer outlines;
+    sf::VertexBuffer tiles;
+    std::size_t outlineVertices = 0;
+
+    std::size_t uploadedCells = 0;
+    std::size_t uploadRuns = 0;
+};
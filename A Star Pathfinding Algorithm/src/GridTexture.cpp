@@ -0,0 +1,134 @@
+#include "GridTexture.h"
+
+#include <algorithm>
+
+namespace
+{
+    // rows sharing one dirty rectangle:
+    const int BAND_ROWS = 16;
+
+    // rows of white sent at a time while a page is filled:
+    const int FILL_ROWS = 64;
+}
+
+bool GridTexture::Layout(int width, int height, sf::Vector2f offset, float pitch)
+{
+    this->width = width;
+    this->height = height;
+    this->offset = offset;
+    this->pitch = pitch;
+
+    palette.assign(1, sf::Color::White);
+    cells.assign(static_cast<std::size_t>(width) * height, 0);
+    bands.assign((height + BAND_ROWS - 1) / BAND_ROWS, Rect());
+    uploadedTexels = 0;
+    uploadRects = 0;
+
+    // as few pages as the GPU allows:
+    pageSize = static_cast<int>(sf::Texture::getMaximumSize());
+    pagesX = (width + pageSize - 1) / pageSize;
+    int pagesY = (height + pageSize - 1) / pageSize;
+    pages.clear();
+    pages.resize(static_cast<std::size_t>(pagesX) * pagesY);
+
+    for (int i = 0; i < static_cast<int>(pages.size()); i++)
+    {
+        Page& page = pages[i];
+        page.left = (i % pagesX) * pageSize;
+        page.top = (i / pagesX) * pageSize;
+        int pageWidth = std::min(pageSize, width - page.left);
+        int pageHeight = std::min(pageSize, height - page.top);
+        if (!page.texture.create(pageWidth, pageHeight))
+            return false;
+
+        // new texture memory is undefined, start white:
+        pixels.assign(4 * static_cast<std::size_t>(pageWidth) * FILL_ROWS, 255);
+        for (int y = 0; y < pageHeight; y += FILL_ROWS)
+            page.texture.update(pixels.data(), pageWidth, std::min(FILL_ROWS, pageHeight - y), 0, y);
+    }
+    return true;
+}
+
+std::uint8_t GridTexture::AddColour(sf::Color colour)
+{
+    if (palette.size() == 256)
+        return 0;
+    palette.push_back(colour);
+    return static_cast<std::uint8_t>(palette.size() - 1);
+}
+
+void GridTexture::Touch(int cell)
+{
+    int x = cell % width;
+    int y = cell / width;
+    Rect& band = bands[y / BAND_ROWS];
+    if (band.right == band.left)
+        band = { x, y, x + 1, y + 1 };
+    else
+    {
+        band.left = std::min(band.left, x);
+        band.top = std::min(band.top, y);
+        band.right = std::max(band.right, x + 1);
+        band.bottom = std::max(band.bottom, y + 1);
+    }
+}
+
+void GridTexture::Upload()
+{
+    uploadedTexels = 0;
+    uploadRects = 0;
+
+    for (Rect& band : bands)
+    {
+        if (band.right == band.left)
+            continue;
+
+        for (Page& page : pages)
+            UploadRect(page, band);
+        band = Rect();
+    }
+}
+
+void GridTexture::UploadRect(Page& page, const Rect& rect)
+{
+    sf::Vector2u size = page.texture.getSize();
+    int left = std::max(rect.left, page.left);
+    int top = std::max(rect.top, page.top);
+    int right = std::min(rect.right, page.left + static_cast<int>(size.x));
+    int bottom = std::min(rect.bottom, page.top + static_cast<int>(size.y));
+    if (left >= right || top >= bottom)
+        return;
+
+    // palette indices -> RGBA, tightly packed like update() wants them:
+    int columns = right - left;
+    pixels.resize(4 * static_cast<std::size_t>(columns) * (bottom - top));
+    sf::Uint8* pixel = pixels.data();
+    for (int y = top; y < bottom; y++)
+    {
+        const std::uint8_t* row = &cells[static_cast<std::size_t>(y) * width];
+        for (int x = left; x < right; x++, pixel += 4)
+        {
+            sf::Color colour = palette[row[x]];
+            pixel[0] = colour.r;
+            pixel[1] = colour.g;
+            pixel[2] = colour.b;
+            pixel[3] = colour.a;
+        }
+    }
+
+    page.texture.update(pixels.data(), columns, bottom - top, left - page.left, top - page.top);
+    uploadedTexels += static_cast<std::size_t>(columns) * (bottom - top);
+    uploadRects++;
+}
+
+void GridTexture::Draw(sf::RenderTarget& target) const
+{
+    // texel (x, y) covers the whole pitch around the centre of cell (x, y):
+    for (const Page& page : pages)
+    {
+        sf::Sprite sprite(page.texture);
+        sprite.setPosition(offset.x + pitch * (page.left - 0.5f), offset.y + pitch * (page.top - 0.5f));
+        sprite.setScale(pitch, pitch);
+        target.draw(sprite);
+    }
+}
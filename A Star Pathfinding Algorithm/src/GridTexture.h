@@ -0,0 +1,92 @@
+#pragma once
+
+#include "SFML/Graphics.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* Grid as a texture, one texel per cell:
+ * drawn as one quad scaled up by the tile pitch, nearest filtering, so
+ * the cost of a frame doesn't depend on how many cells are in view. a
+ * grid wider or taller than the GPU's largest texture is split into
+ * pages, one quad each.
+ *
+ * colours are mirrored a byte per cell (index into a small palette),
+ * SetColour() only records cells whose colour really changed, grown
+ * into one bounding rectangle per band of rows, and Upload() sends
+ * just those rectangles with sf::Texture::update().
+ */
+class GridTexture
+{
+public:
+    // centre of cell (x, y) at offset + pitch * (x, y), every cell starts out white. false if a page couldn't be created:
+    bool Layout(int width, int height, sf::Vector2f offset, float pitch);
+
+    void SetColour(int cell, sf::Color colour)
+    {
+        std::uint8_t index = PaletteIndex(colour);
+        if (cells[cell] == index)
+            return;
+        cells[cell] = index;
+        Touch(cell);
+    }
+
+    // changed rectangles -> textures:
+    void Upload();
+
+    void Draw(sf::RenderTarget& target) const;
+
+    // sent by the last Upload():
+    std::size_t UploadedTexels() const { return uploadedTexels; }
+    std::size_t UploadRects() const { return uploadRects; }
+
+private:
+    struct Rect
+    {
+        int left = 0;
+        int top = 0;
+        int right = 0;      // exclusive, right == left means empty
+        int bottom = 0;
+    };
+
+    struct Page
+    {
+        sf::Texture texture;
+        int left = 0;       // first cell column
+        int top = 0;        // first cell row
+    };
+
+    // only a handful of colours are ever used:
+    std::uint8_t PaletteIndex(sf::Color colour)
+    {
+        for (std::size_t i = 0; i < palette.size(); i++)
+            if (palette[i] == colour)
+                return static_cast<std::uint8_t>(i);
+        return AddColour(colour);
+    }
+    std::uint8_t AddColour(sf::Color colour);
+
+    // grows the dirty rectangle of cell's band:
+    void Touch(int cell);
+
+    // copies cells of rect that fall on page into it:
+    void UploadRect(Page& page, const Rect& rect);
+
+    int width = 0;
+    int height = 0;
+    sf::Vector2f offset;
+    float pitch = 0.f;
+
+    std::vector<sf::Color> palette;
+    std::vector<std::uint8_t> cells;    // palette index per cell
+    std::vector<Rect> bands;            // changes since the last Upload(), per band of rows
+    std::vector<sf::Uint8> pixels;      // rectangle on its way to the GPU
+
+    int pageSize = 0;
+    int pagesX = 0;
+    std::vector<Page> pages;
+
+    std::size_t uploadedTexels = 0;
+    std::size_t uploadRects = 0;
+};
@@ -2,21 +2,69 @@
 #include "../imgui/imgui.h"
 #include "../imgui/imgui-SFML.h"
 
+#include "GridRenderer.h"
+#include "GridTexture.h"
+
+#include "AStar.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "Hierarchy.h"
+#include "IncrementalPlanner.h"
+#include "MapFile.h"
+#include "PathCache.h"
+#include "ResumableSearch.h"
+#include "SearchContext.h"
+#include "SearchWorker.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <string>
 #include <vector>
 #include <cmath>
+#include <algorithm>
 
 static const int SCREEN_WIDTH = 800;
 static const int SCREEN_HEIGHT = 600;
 
-static const int mapWidth = 20;
-static const int mapHeight = 20;
-
-/* Forward declare Node struct: */
-struct Node;
-
-using Tile = sf::RectangleShape;
+/* edits + searches advance in fixed ticks, frames are only drawn when
+ * something changed (or for a few frames after input, imgui needs them
+ * to settle hover + click state):
+ */
+static const sf::Time TICK = sf::seconds(1.f / 60);
+static const int MAX_TICKS = 5;         // per loop, a slow frame isn't followed by a burst
+static const int SETTLE_FRAMES = 3;
+bool redraw = true;             // state changed since the last frame
+int settleFrames = SETTLE_FRAMES;
+bool vsync = true;
+int frameCap = 0;               // frames per second, 0 = no cap
+bool shaderUI = true;           // menus from vertex buffers + a shader, fixed-function if the driver lacks them
+int frameRate = 0;              // frames + ticks over the last second
+int tickRate = 0;
+
+// grid size until the command line or the menu picks another:
+static const int DEFAULT_MAP_WIDTH = 20;
+static const int DEFAULT_MAP_HEIGHT = 20;
+static const int MAX_MAP_SIDE = 10000;
+
+// tile layout in world units, the camera scales it onto the window:
+static const float GRID_OFFSET = 20.f;      // centre of the first tile
+static const float TILE_PITCH = 28.f;       // distance between tile centres
+static const float TILE_SIZE = 25.f;
+static const float TILE_OUTLINE = 1.f;
+static const sf::Color BACKGROUND = sf::Color::Blue;    // shows through the gaps between tiles
+
+// camera, zoom = screen pixels per world unit:
+static const float MIN_TILE_ZOOM = 2.f / TILE_PITCH;    // tiles never under 2 pixels, caps the tiles in view
+static const float MAX_ZOOM = 4.f;
+static const float ZOOM_STEP = 1.2f;                // per mouse wheel notch
+sf::View camera;
+float cameraZoom = 1.f;
+bool panning = false;           // middle mouse held
+sf::Vector2i panPixel{};        // where the last pan step ended
 
 // mouse flags:
 bool mouseLeftDown = false;
@@ -26,311 +74,502 @@ bool endKeyDown = false;
 
 bool algorithmStart = false;
 
+TieBreak tieBreak = TieBreak::LastIn;
+Engine engine = Engine::AStar;
+bool hierarchical = false;      // HPA* instead of engine
+int clusterSize = Hierarchy::DEFAULT_CLUSTER_SIZE;     // HPA* cluster side, smaller strays further from the shortest path
+bool livePath = false;          // replan incrementally as walls change (LPA*)
+bool livePathStale = true;      // edits since the live path was planned
+
 // sfml + imgui window inits:
 sf::RenderWindow window(
     sf::VideoMode(SCREEN_WIDTH, SCREEN_HEIGHT),
     "A* Pathfinding Algorithm");
 
-// grid of nodes:
-std::vector<Node> nodes{ mapWidth * mapHeight };
+// walls + connections, search state (sized by the first search):
+Grid grid{ DEFAULT_MAP_WIDTH, DEFAULT_MAP_HEIGHT };
+SearchContext searchContext;
+
+// search tree kept between wall edits for the live path, created on first use:
+std::unique_ptr<IncrementalPlanner> planner;
+
+// results of earlier visualise runs, dropped as wall edits touch them:
+PathCache pathCache{ grid, 64 };
+
+// A* spread over ticks when the worker is off, so big searches never stall a frame:
+ResumableSearch steppedSearch{ grid, searchContext };
+int tickExpansions = 10;        // cells expanded per tick, 0 = no limit
+int tickMicros = 4000;          // search time per tick
 
-// mouse coords:
-sf::Vector2f mpos{};
+// or searches on their own thread (always for the other engines + HPA*), progress drained once per tick:
+SearchWorker searchWorker;
+bool useWorker = true;
+bool workerBusy = false;
+std::vector<int> workerPath;    // path cells received so far
+std::size_t workerExpanded = 0;
 
-Node* startNode = nullptr;
-Node* endNode = nullptr;
+// what the search running off the frame was asked for, its result is cached under this, not whatever is set by then:
+int searchStart = -1;
+int searchEnd = -1;
+std::uint32_t searchVariant = 0;
+
+// how the grid is drawn, same colours either way:
+enum class RenderMode
+{
+    Tiles,      // a quad per tile in view, with outlines
+    Texture     // a texel per cell, whole map at any zoom
+};
+RenderMode renderMode = RenderMode::Tiles;
+
+// tiles in view in one vertex buffer, coloured from grid + search state:
+GridRenderer gridRenderer;
+
+/* or every cell in a texture. cells known to have changed are redrawn
+ * at once, the rest (searches on this thread write straight into their
+ * context) is caught up by a sweep over a slice of rows per frame.
+ */
+static const int SWEEP_CELLS = 1 << 20;     // cells rechecked per frame
+GridTexture gridTexture;
+std::vector<int> changedCells;  // edits + worker expansions since the last frame
+std::vector<int> drawnPath;     // path cells as last drawn, sorted
+int drawnStart = -1;
+int drawnEnd = -1;
+const SearchContext* drawnSearched = nullptr;
+int sweepRow = 0;               // next row the sweep rechecks
+int sweepRows = 0;              // rows left to recheck
+bool sweepAll = false;          // every row this frame, after every cell changed
+
+// cursor positions since the last tick while a button is held, so fast strokes leave no gaps:
+std::vector<sf::Vector2i> strokePixels;
+
+// -1 = not placed:
+int startCell = -1;
+int endCell = -1;
+
+// cells of the last path found (start -> end):
+std::vector<int> path;
+
+// 1 = on path, per tile in view, rebuilt by every Render():
+std::vector<std::uint8_t> pathMarks;
 
 /* Forward Declarations: */
 // Inits:
-void InitGridConnections();
-void HandleTileClick(const sf::Color& colour);
+void Usage();
+bool ValidSize(int width, int height);
+bool ParseArguments(int argc, char* argv[]);
+void SetGrid(Grid next);
+void LayoutTiles();
+bool LayoutTexture();
+float MinZoom();
+void ResetCamera();
+void ZoomCamera(float factor, sf::Vector2i pixel);
+int TileAt(sf::Vector2f point);
+void HandleTileClick(sf::Vector2f point);
+void SetWall(int cell, bool blocked);
 
 // Main Algorithm:
-void AStarAlgorithm();
-
-// A* Path:
-void RetracePath();
+void PrepareSearch();
+std::uint32_t SearchVariant();
+void RunSearch();
+void StepSearch();
+bool DrainWorker();
+void CancelSearch();
+bool UpdateLivePath();
 
 // Main loop:
 void UpdateImGuiContext();
-void Update(sf::Clock& dt);
+bool HandleEvents();
+void Tick();
+sf::Color TileColour(int cell, bool onPath, const SearchContext* searched);
+void RenderTiles(const SearchContext* searched);
+void RenderTexture(const SearchContext* searched);
 void Render();
 
-int main()
+int main(int argc, char* argv[])
 {
+    if (!ParseArguments(argc, argv))
+        return 1;
+
     ImGui::SFML::Init(window);
+    if (!ImGui::SFML::SetShaderRendering(shaderUI))
+        shaderUI = false;
 
-    // setup tile grid:
-    InitGridConnections();
+    window.setVerticalSyncEnabled(vsync);
 
-    sf::Clock dt;
+    // setup tile grid:
+    LayoutTiles();
+
+    sf::Clock tickClock;
+    sf::Clock frameClock;
+    sf::Clock rateClock;
+    sf::Time lag;
+    int frames = 0;
+    int ticks = 0;
     while (window.isOpen())
     {
-        Update(dt);
+        // input as it arrives, acted on by the next tick:
+        if (HandleEvents())
+            settleFrames = SETTLE_FRAMES;
+
+        // simulation at a fixed rate, however often frames are drawn:
+        lag += tickClock.restart();
+        for (int i = 0; lag >= TICK && i < MAX_TICKS; i++, ticks++)
+        {
+            Tick();
+            lag -= TICK;
+        }
+        if (lag >= TICK)
+            lag = sf::Time::Zero;   // too far behind, the rest is dropped
+
+        if (rateClock.getElapsedTime() >= sf::seconds(1.f))
+        {
+            frameRate = frames;
+            tickRate = ticks;
+            frames = ticks = 0;
+            rateClock.restart();
+        }
+
+        // nothing changed, nothing to draw: sleep until the next tick
+        if (!redraw && settleFrames == 0)
+        {
+            sf::sleep(TICK - lag);
+            continue;
+        }
+        redraw = false;
+        settleFrames = std::max(0, settleFrames - 1);
+        frames++;
+
+        ImGui::SFML::Update(window, frameClock.restart());
         UpdateImGuiContext();  /* imgui menu: */
         Render();
     }
     ImGui::SFML::Shutdown();
 }
 
-struct Node
+void Usage()
 {
-    // init tile w/ default values:
-    Node(
-        const sf::Vector2f& size = { 25.f, 25.f },
-        const sf::Color& colour = sf::Color::White,
-        const float outlineThickness = 1.f,
-        const sf::Color& outlineColour = sf::Color::Black)
+    std::cerr << "usage: \"A Star Pathfinding Algorithm\" [--size <width> <height>] [--map <map file>]\n"
+        << "  --size  empty grid, up to " << MAX_MAP_SIDE << " cells a side (default: "
+        << DEFAULT_MAP_WIDTH << " x " << DEFAULT_MAP_HEIGHT << ")\n"
+        << "  --map   walls from a Moving AI .map file\n";
+}
+
+bool ValidSize(int width, int height)
+{
+    return width > 0 && height > 0 && width <= MAX_MAP_SIDE && height <= MAX_MAP_SIDE;
+}
+
+bool ParseArguments(int argc, char* argv[])
+{
+    for (int i = 1; i < argc; i++)
     {
-        tile.setSize(size);
-        tile.setFillColor(colour);
-        tile.setOutlineThickness(outlineThickness);
-        tile.setOutlineColor(outlineColour);
+        std::string arg = argv[i];
+        if (arg == "--size" && i + 2 < argc)
+        {
+            int width = std::atoi(argv[++i]);
+            int height = std::atoi(argv[++i]);
+            if (!ValidSize(width, height))
+            {
+                std::cerr << "bad grid size: " << width << " x " << height << "\n";
+                return false;
+            }
+            SetGrid(Grid(width, height));
+        }
+        else if (arg == "--map" && i + 1 < argc)
+        {
+            Grid loaded(1, 1);
+            if (!LoadMap(argv[++i], loaded) || !ValidSize(loaded.width, loaded.height))
+            {
+                std::cerr << "can't load map: " << argv[i] << "\n";
+                return false;
+            }
+            SetGrid(std::move(loaded));
+        }
+        else
+        {
+            Usage();
+            return false;
+        }
     }
+    return true;
+}
 
-    // individual grid squares:
-    Tile tile;
+void SetGrid(Grid next)
+{
+    // everything sized for the old grid goes, and is rebuilt on first use:
+    CancelSearch();
+    grid = std::move(next);
+    searchContext = SearchContext();
+    planner.reset();
+    pathCache.Clear();
+
+    startCell = endCell = -1;
+    path.clear();
+    livePathStale = true;
+    LayoutTiles();
+}
 
-    // track current node's parent:
-    Node* parent = nullptr;
+void LayoutTiles()
+{
+    gridRenderer.Layout(grid.width, grid.height, { GRID_OFFSET, GRID_OFFSET },
+        TILE_PITCH, TILE_SIZE, TILE_OUTLINE, BACKGROUND);
+
+    // texture memory only while it's drawn:
+    if (renderMode == RenderMode::Texture && !LayoutTexture())
+        renderMode = RenderMode::Tiles;
+    ResetCamera();
+    redraw = true;
+}
 
-    // surrounding nodes for any given node:
-    std::vector<Node*> neighbours;
+bool LayoutTexture()
+{
+    changedCells.clear();
+    drawnPath.clear();
+    drawnStart = drawnEnd = -1;
+    sweepAll = true;
 
-    // walls:
-    bool obstacle = false;
-    bool visited = false;
+    if (gridTexture.Layout(grid.width, grid.height, { GRID_OFFSET, GRID_OFFSET }, TILE_PITCH))
+        return true;
 
-    float gcost = 0.0f;    // distance from start node
-    float hcost = 0.0f;    // distance from end node (heuristic)
-    float fcost = 0.0f;    // g + h = fcost
+    std::cerr << "can't create textures for a " << grid.width << " x " << grid.height << " grid\n";
+    return false;
+}
 
-    // helper function,
-    // return tile x, y coords:
-    auto GetTilePosition()
-    {
-        return sf::Vector2f(
-            tile.getPosition().x,
-            tile.getPosition().y);
-    }
-};
+float MinZoom()
+{
+    if (renderMode == RenderMode::Tiles)
+        return MIN_TILE_ZOOM;
+
+    // a texture costs the same at any zoom, the whole grid can be in view:
+    sf::Vector2f screen(window.getSize());
+    return std::min({ MIN_TILE_ZOOM, screen.x / (TILE_PITCH * grid.width), screen.y / (TILE_PITCH * grid.height) });
+}
+
+void ResetCamera()
+{
+    // whole grid if it fits at a readable size, never zoomed in past 1:1:
+    sf::Vector2f screen(window.getSize());
+    float fitX = (screen.x - GRID_OFFSET) / (TILE_PITCH * grid.width);
+    float fitY = (screen.y - GRID_OFFSET) / (TILE_PITCH * grid.height);
+    cameraZoom = std::clamp(std::min(fitX, fitY), MinZoom(), 1.f);
+
+    camera.reset(sf::FloatRect(0.f, 0.f, screen.x / cameraZoom, screen.y / cameraZoom));
+}
+
+void ZoomCamera(float factor, sf::Vector2i pixel)
+{
+    float zoom = std::clamp(cameraZoom * factor, MinZoom(), MAX_ZOOM);
+
+    // the point under the cursor stays put:
+    sf::Vector2f before = window.mapPixelToCoords(pixel, camera);
+    camera.zoom(cameraZoom / zoom);
+    cameraZoom = zoom;
+    camera.move(before - window.mapPixelToCoords(pixel, camera));
+}
+
+int TileAt(sf::Vector2f point)
+{
+    // nearest tile centre, O(1) however big the grid:
+    int x = static_cast<int>(std::floor((point.x - GRID_OFFSET) / TILE_PITCH + 0.5f));
+    int y = static_cast<int>(std::floor((point.y - GRID_OFFSET) / TILE_PITCH + 0.5f));
+    if (x < 0 || x >= grid.width || y < 0 || y >= grid.height)
+        return -1;
+
+    // the gap between tiles belongs to neither:
+    float reach = TILE_SIZE / 2 + TILE_OUTLINE;
+    if (std::abs(point.x - (GRID_OFFSET + TILE_PITCH * x)) > reach ||
+        std::abs(point.y - (GRID_OFFSET + TILE_PITCH * y)) > reach)
+        return -1;
+
+    return grid.Index(x, y);
+}
 
-void InitGridConnections()
+void HandleTileClick(sf::Vector2f point)
 {
-    // setup tile position as grid:
-    float col = 20.f;
-    for (int x = 0; x < mapWidth; x++)
+    // if tile click...
+    int cell = TileAt(point);
+    if (cell < 0)
+        return;
+
+    // set start node:
+    if (sf::Keyboard
+        ::isKeyPressed(sf::Keyboard::S))
     {
-        float row = 20.f;
-        for (int y = 0; y < mapHeight; y++)
-        {
-            // set origin to center of each node:
-            nodes[x + mapWidth * y].tile
-                .setOrigin(
-                    sf::Vector2f(
-                        nodes[x + mapWidth * y].tile.getPosition().x +
-                        (nodes[x + mapWidth * y].tile.getGlobalBounds().width / 2),
-                        nodes[x + mapWidth * y].tile.getPosition().y +
-                        (nodes[x + mapWidth * y].tile.getGlobalBounds().height / 2)));
-
-            nodes[x + mapWidth * y].tile
-                .setPosition(row, col);
-            row += 28.f;
-        }
-        col += 28.f;
+        if (cell != startCell)
+            CancelSearch();
+        startCell = cell;
     }
-
-    // create references for current node with neighbours (surrouding nodes):
-    for (int x = 0; x < mapWidth; x++)
+    // set end node:
+    else if (sf::Keyboard
+        ::isKeyPressed(sf::Keyboard::E))
     {
-        for (int y = 0; y < mapHeight; y++)
-        {
-            // N-E-S-W connections:
-            // top node
-            if (y > 0)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[x + mapWidth * (y - 1)]);
-            // right node
-            if (x < mapWidth - 1)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[(x + 1) + mapWidth * y]);
-            // bottom node
-            if (y < mapHeight - 1)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[x + mapWidth * (y + 1)]);
-            // left node
-            if (x > 0)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[(x - 1) + mapWidth * y]);
-
-            // diagonal connections:
-            // top left
-            if (y > 0 && x > 0)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[(x - 1) + mapWidth * (y - 1)]);
-            // top right
-            if (y > 0 && x < mapWidth - 1)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[(x + 1) + mapWidth * (y - 1)]);
-            // bottom right
-            if (y < mapHeight - 1 && x < mapWidth - 1)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[(x + 1) + mapWidth * (y + 1)]);
-            // bottom left
-            if (y < mapHeight - 1 && x > 0)
-                nodes[x + mapWidth * y]
-                    .neighbours.push_back(&nodes[(x - 1) + mapWidth * (y + 1)]);
-        }
+        if (cell != endCell)
+            CancelSearch();
+        endCell = cell;
     }
+    // remove walls:
+    else if (sf::Mouse
+        ::isButtonPressed(sf::Mouse::Right))
+        SetWall(cell, false);
+    // set walls:
+    else
+        SetWall(cell, true);
 }
 
-void HandleTileClick(const sf::Color& colour = sf::Color::Black)
+void SetWall(int cell, bool blocked)
 {
-    for (auto& row : nodes)
-    {
-        // if tile click...
-        if (row.tile
-            .getGlobalBounds().contains(mpos))
-        {
-            // set start node:
-            if (sf::Keyboard
-                ::isKeyPressed(sf::Keyboard::S))
-            {
-                row.tile
-                    .setFillColor(sf::Color::Green);
-                startNode = &row;
-            }
-            // set end node:
-            else if (sf::Keyboard
-                ::isKeyPressed(sf::Keyboard::E))
-            {
-                row.tile
-                    .setFillColor(sf::Color::Red);
-                endNode = &row;
-            }
-            // remove walls:
-            else if (sf::Mouse
-                ::isButtonPressed(sf::Mouse::Right))
-            {
-                row.tile
-                    .setFillColor(sf::Color::White);
-                row.obstacle = false;
-            }
-            // set walls:
-            else
-            {
-                row.tile
-                    .setFillColor(colour);
-                row.obstacle = true;
-            }
-        }
-    }
+    // held mouse buttons repeat every frame, only real changes reach the cache, worker + planner:
+    if ((grid.obstacle[cell] != 0) == blocked)
+        return;
+
+    // a running search would mix old + new walls:
+    CancelSearch();
+
+    grid.SetObstacle(cell, blocked);
+    changedCells.push_back(cell);
+    livePathStale = true;
+    pathCache.CellChanged(cell);
+    searchWorker.CellChanged(cell);
+    if (planner)
+        planner->CellChanged(cell);
 }
 
-// Path generated by A* algorithm:
-void RetracePath()
+void PrepareSearch()
 {
-    Node* tracker = endNode;
-    while (tracker->parent != nullptr) {
-        // continue to update tracker to current node's parent until start node is reached:
-        tracker = tracker->parent;
-
-        // only colour in path:
-        if (tracker != startNode)
-            tracker->tile.setFillColor(sf::Color::Yellow);
-    }
+    // per-cell search state only once something is searched, a big grid starts small:
+    if (static_cast<int>(searchContext.visited.size()) != grid.Size())
+        searchContext.Resize(grid.Size());
+}
+
+std::uint32_t SearchVariant()
+{
+    // everything besides the endpoints a path depends on, keeps cached paths apart:
+    if (hierarchical)
+        return static_cast<std::uint32_t>(clusterSize) << 8 | 2u | (tieBreak == TieBreak::FirstIn ? 1u : 0u);
+    return static_cast<std::uint32_t>(engine) << 2 | (tieBreak == TieBreak::FirstIn ? 1u : 0u);
 }
 
 /* Main Algorithm : */
-void AStarAlgorithm()
+void RunSearch()
 {
-    /* returns distance between any two given tiles.
-     * used for calculating g and h costs
-     */
-    auto distance = [](Node* a, Node* b) -> float
+    algorithmStart = false;     // stops algorithm
+
+    // nothing to search between:
+    if (startCell < 0 || endCell < 0)
+        return;
+
+    CancelSearch();
+    PrepareSearch();
+
+    // same endpoints, no edits in the way since: nothing left to search
+    if (const SearchResult* cached = pathCache.Find(startCell, endCell, SearchVariant()))
     {
-        return sqrtf(
-            std::pow(a->GetTilePosition().x - b->GetTilePosition().x, 2) +
-            std::pow(a->GetTilePosition().y - b->GetTilePosition().y, 2));
-    };
+        searchContext.NewSearch();
+        path = cached->path;
+        sweepRows = grid.height;
+        return;
+    }
 
-    // list of nodes to test:
-    std::vector<Node*> openList{};
-    // list of tested nodes:
-    std::vector<Node*> closedList{};
-    openList.push_back(startNode);
+    // every search runs off the frame, A* spread over ticks if the worker is off, anything else on the worker:
+    path.clear();
+    searchStart = startCell;
+    searchEnd = endCell;
+    searchVariant = SearchVariant();
+    if (useWorker || hierarchical || engine != Engine::AStar)
+    {
+        // cells only show as searched once the worker reports them:
+        searchContext.NewSearch();
+        workerPath.clear();
+        workerExpanded = 0;
+        searchWorker.Submit(grid, startCell, endCell, tieBreak, engine, hierarchical ? clusterSize : 0);
+        workerBusy = true;
+    }
+    else
+        steppedSearch.Start(startCell, endCell, tieBreak);
+    sweepRows = grid.height;
+}
 
-    while (!openList.empty())
+void StepSearch()
+{
+    bool finished = steppedSearch.Step(
+        static_cast<std::size_t>(tickExpansions),
+        std::chrono::microseconds(tickMicros));
+    sweepRows = grid.height;
+
+    if (finished)
+        path = pathCache.Insert(searchStart, searchEnd, steppedSearch.Result(), searchVariant).path;
+    // best guess so far, start -> last expanded cell:
+    else if (steppedSearch.CurrentCell() >= 0)
+        path = RetracePath(searchContext, steppedSearch.CurrentCell());
+}
+
+bool UpdateLivePath()
+{
+    if (!planner)
+        planner = std::make_unique<IncrementalPlanner>(grid);
+
+    // new endpoints start a fresh tree, otherwise only wall edits are repaired:
+    if (planner->StartCell() != startCell || planner->EndCell() != endCell)
     {
-        Node* currentNode = openList.front();
+        planner->Reset(startCell, endCell);
+        livePathStale = true;
+    }
 
-        // find lowest fcost node from openlist:
-        for (int i = 1; i < openList.size(); i++)
-        {
-            if (openList[i]->fcost < currentNode->fcost
-                || openList[i]->fcost == currentNode->fcost 
-                && openList[i]->hcost < currentNode->hcost)
-            {
-                currentNode = openList[i];
-            }
-        }
-            
-        // remove currentNode (lowest fcost node thats searched) from openlist: 
-        openList.erase(
-            std::remove(
-                openList.begin(), openList.end(), currentNode), openList.end());
+    // no edits since, same path:
+    if (!livePathStale)
+        return false;
 
-        // add it to closed list:
-        closedList.push_back(currentNode);
+    path = planner->ComputePath().path;
+    sweepRows = grid.height;
+    livePathStale = false;
+    return true;
+}
 
-        // end goal reached:
-        if (currentNode == endNode)
+bool DrainWorker()
+{
+    bool drained = false;
+    SearchUpdate update;
+    while (searchWorker.Poll(update))
+    {
+        drained = true;
+        switch (update.kind)
         {
-            RetracePath();
-            algorithmStart = false;     // stops algorithm
-            return;
-        }
+        case SearchUpdate::Kind::Expanded:
+            searchContext.Close(update.cell);   // drawn as searched
+            changedCells.push_back(update.cell);
+            workerExpanded++;
+            break;
 
-        /* Search surrouding neighbour nodes of currentNode (startnode by default). 
-         * order in which neighbours list is processed (counter clockwise): 
-         * left, botom, right, top, top-left, bottom-left, top-right, bottom-right.
-         */
-        for (auto& currentNeighbour : currentNode->neighbours)
-        {
-            if (currentNeighbour->obstacle ||
-                std::find(
-                    closedList.begin(),
-                    closedList.end(),
-                    currentNeighbour) != closedList.end())
-                continue;
-
-            float costToMove =
-                currentNode->gcost + distance(currentNode, currentNeighbour);
-
-            if (costToMove < currentNeighbour->gcost || 
-                !(std::find(
-                    openList.begin(),
-                    openList.end(),
-                    currentNeighbour) != openList.end()))
-            {
-                currentNeighbour->parent = currentNode;
-                currentNeighbour->gcost = costToMove;
-                currentNeighbour->hcost = distance(currentNeighbour, endNode);
-                currentNeighbour->fcost = currentNeighbour->gcost + currentNeighbour->hcost;
-                
-                openList.push_back(currentNeighbour);
-                
-                // colour in searched nodes:
-                if (currentNeighbour != endNode)
-                    currentNeighbour->tile.setFillColor(sf::Color::Magenta);
-            }
+        case SearchUpdate::Kind::PathCell:
+            workerPath.push_back(update.cell);
+            break;
 
-            /*printf("x: %.0f y: %.0f fcost: %.0f\n", 
-                currentNeighbour->tile.getPosition().x, 
-                currentNeighbour->tile.getPosition().y, 
-                currentNeighbour->fcost);*/
+        case SearchUpdate::Kind::Finished:
+        {
+            SearchResult result;
+            result.found = update.cell >= 0;
+            result.cost = update.cost;
+            result.path = std::move(workerPath);
+            result.expanded = workerExpanded;
+            path = pathCache.Insert(searchStart, searchEnd, std::move(result), searchVariant).path;
+            workerPath.clear();
+            workerBusy = false;
+            break;
+        }
         }
     }
+    return drained;
+}
+
+void CancelSearch()
+{
+    // the worker drops it within a few hundred expansions, nothing more is drained:
+    steppedSearch.Cancel();
+    if (workerBusy)
+    {
+        searchWorker.Cancel();
+        workerBusy = false;
+    }
 }
 
 void UpdateImGuiContext()
@@ -340,26 +579,138 @@ void UpdateImGuiContext()
     if (ImGui::Button("visualise"))
         algorithmStart = true;
 
+    if (workerBusy || steppedSearch.Running())
+    {
+        ImGui::SameLine();
+        if (ImGui::Button("cancel"))
+            CancelSearch();
+    }
+
+    // search engine, same path cost either way:
+    static const char* engineNames[] = { "A*", "Jump Point Search", "Bidirectional A*", "A* (integer octile)" };
+    int selected = static_cast<int>(engine);
+    if (ImGui::Combo("engine", &selected, engineNames, IM_ARRAYSIZE(engineNames)))
+        engine = static_cast<Engine>(selected);
+
+    // search clusters, then refine (approximate, paths can come out longer than the shortest):
+    ImGui::Checkbox("hierarchical (HPA*, approximate)", &hierarchical);
+    if (hierarchical)
+        ImGui::SliderInt("cluster size", &clusterSize, 4, 64, "%d", ImGuiSliderFlags_AlwaysClamp);
+
+    // A* off the render thread, or time-sliced on it (the other engines always use the worker):
+    ImGui::Checkbox("A* on worker thread", &useWorker);
+
+    // time-sliced A* speed, whichever budget runs out first ends the frame's share:
+    ImGui::SliderInt("cells / tick", &tickExpansions, 0, 1000, tickExpansions == 0 ? "no limit" : "%d");
+    ImGui::SliderInt("us / tick", &tickMicros, 100, 16000);
+
+    // path follows wall edits as they're drawn:
+    if (ImGui::Checkbox("live path (LPA*)", &livePath))
+    {
+        if (!livePath)
+            path.clear();
+        livePathStale = true;
+    }
+
+    // tie-break policy for equal cost nodes:
+    static const char* tieBreakNames[] = { "last in", "first in" };
+    int policy = tieBreak == TieBreak::LastIn ? 0 : 1;
+    if (ImGui::Combo("tie-break", &policy, tieBreakNames, IM_ARRAYSIZE(tieBreakNames)))
+        tieBreak = policy == 0 ? TieBreak::LastIn : TieBreak::FirstIn;
+
     if (ImGui::Button("clear"))
     {
-        for (auto& row : nodes)
+        // search costs are per-generation, only walls need resetting:
+        startCell = endCell = -1;
+        CancelSearch();
+        searchContext.NewSearch();
+        path.clear();
+        grid.ClearObstacles();
+        sweepAll = true;
+        if (planner)
+            planner->Reset(-1, -1);
+        livePathStale = true;
+        pathCache.Clear();
+    }
+
+    // grid size, anything built for the old grid is dropped:
+    ImGui::Separator();
+    static int newSize[2] = { grid.width, grid.height };
+    ImGui::InputInt2("##size", newSize);
+    ImGui::SameLine();
+    if (ImGui::Button("resize") && ValidSize(newSize[0], newSize[1]))
+        SetGrid(Grid(newSize[0], newSize[1]));
+
+    static char mapFile[256] = "";
+    ImGui::InputText("##map", mapFile, sizeof(mapFile));
+    ImGui::SameLine();
+    if (ImGui::Button("load map"))
+    {
+        Grid loaded(1, 1);
+        if (LoadMap(mapFile, loaded) && ValidSize(loaded.width, loaded.height))
         {
-            startNode = endNode = nullptr;
-            row.parent = nullptr;
-            row.obstacle = false;
-            row.gcost = row.hcost = row.fcost = 0;
-            row.tile
-                .setFillColor(sf::Color::White);
+            SetGrid(std::move(loaded));
+            newSize[0] = grid.width;
+            newSize[1] = grid.height;
         }
     }
+    ImGui::Text("grid: %d x %d", grid.width, grid.height);
+
+    // path cache counters:
+    ImGui::Separator();
+    ImGui::Text("cached paths: %zu / %zu", pathCache.Size(), pathCache.Capacity());
+    ImGui::Text("hits: %zu  misses: %zu", pathCache.Hits(), pathCache.Misses());
+    ImGui::Text("evictions: %zu  invalidated: %zu", pathCache.Evictions(), pathCache.Invalidations());
+
+    // tiles or texture, sent last frame, follows edits, not map size:
+    ImGui::Separator();
+    static const char* renderModeNames[] = { "tiles", "texture" };
+    int mode = static_cast<int>(renderMode);
+    if (ImGui::Combo("render", &mode, renderModeNames, IM_ARRAYSIZE(renderModeNames)))
+    {
+        renderMode = static_cast<RenderMode>(mode);
+        if (renderMode == RenderMode::Texture && !LayoutTexture())
+            renderMode = RenderMode::Tiles;
+
+        // tiles can't be zoomed out as far:
+        ZoomCamera(1.f, sf::Vector2i(window.getSize() / 2u));
+    }
+
+    if (renderMode == RenderMode::Tiles)
+    {
+        ImGui::Text("tiles uploaded: %zu in %zu runs (%.1f KB)", gridRenderer.UploadedCells(),
+            gridRenderer.UploadRuns(), gridRenderer.UploadedBytes() / 1024.0);
+        const GridRenderer::Window& visible = gridRenderer.Visible();
+        ImGui::Text("tiles in view: %d x %d", visible.Width(), visible.Height());
+    }
+    else
+        ImGui::Text("texels uploaded: %zu in %zu rects (%.1f KB)", gridTexture.UploadedTexels(),
+            gridTexture.UploadRects(), gridTexture.UploadedTexels() * 4 / 1024.0);
+
+    // camera, middle mouse drags + wheel zooms:
+    ImGui::Text("zoom: %.3f", cameraZoom);
+    if (ImGui::Button("reset view"))
+        ResetCamera();
+
+    // frames are only drawn when something changed, at most this often:
+    ImGui::Separator();
+    if (ImGui::Checkbox("vsync", &vsync))
+        window.setVerticalSyncEnabled(vsync);
+    if (ImGui::SliderInt("frame cap", &frameCap, 0, 240, frameCap == 0 ? "no cap" : "%d"))
+        window.setFramerateLimit(frameCap);
+    if (ImGui::Checkbox("shader UI renderer", &shaderUI) && !ImGui::SFML::SetShaderRendering(shaderUI))
+        shaderUI = false;
+    ImGui::Text("frames: %d / s  ticks: %d / s", frameRate, tickRate);
     ImGui::End();
 }
 
-void Update(sf::Clock& dt)
+bool HandleEvents()
 {
+    bool input = false;
     sf::Event event;
     while (window.pollEvent(event))
     {
+        input = true;
         ImGui::SFML::ProcessEvent(event);
         switch (event.type)
         {
@@ -401,10 +752,18 @@ void Update(sf::Clock& dt)
             {
             case sf::Mouse::Left:
                 mouseLeftDown = true;
+                strokePixels.push_back({ event.mouseButton.x, event.mouseButton.y });
                 break;
 
             case sf::Mouse::Right:
                 mouseRightDown = true;
+                strokePixels.push_back({ event.mouseButton.x, event.mouseButton.y });
+                break;
+
+                // pan:
+            case sf::Mouse::Middle:
+                panning = true;
+                panPixel = { event.mouseButton.x, event.mouseButton.y };
                 break;
             }
             break;
@@ -419,49 +778,201 @@ void Update(sf::Clock& dt)
             case sf::Mouse::Right:
                 mouseRightDown = false;
                 break;
+
+            case sf::Mouse::Middle:
+                panning = false;
+                break;
             }
             break;
 
         case sf::Event::MouseMoved:
-            // current mouse position:
-            mpos = window
-                .mapPixelToCoords(
-                    sf::Mouse::getPosition(window));
+            if (mouseLeftDown || mouseRightDown)
+                strokePixels.push_back({ event.mouseMove.x, event.mouseMove.y });
+
+            // grid follows the cursor while panning:
+            if (panning)
+            {
+                sf::Vector2i pixel(event.mouseMove.x, event.mouseMove.y);
+                camera.move(window.mapPixelToCoords(panPixel, camera) - window.mapPixelToCoords(pixel, camera));
+                panPixel = pixel;
+            }
+            break;
+
+            // zoom about the cursor, unless it's over the menu:
+        case sf::Event::MouseWheelScrolled:
+            if (!ImGui::GetIO().WantCaptureMouse)
+                ZoomCamera(event.mouseWheelScroll.delta > 0 ? ZOOM_STEP : 1 / ZOOM_STEP,
+                    { event.mouseWheelScroll.x, event.mouseWheelScroll.y });
+            break;
+
+            // same zoom, more or less of the grid in view:
+        case sf::Event::Resized:
+            camera.setSize(event.size.width / cameraZoom, event.size.height / cameraZoom);
             break;
         }
     }
 
-    /* Update */
-    ImGui::SFML::Update(
-        window, dt.restart());
+    return input;
+}
 
-    // start/end node:
-    if (mouseLeftDown &&
-        (startKeyDown || endKeyDown))
-        HandleTileClick();
+void Tick()
+{
+    std::uint64_t version = grid.version;
+    int start = startCell;
+    int end = endCell;
 
-    // draw walls:
-    if (mouseLeftDown)
-        HandleTileClick();
+    // start/end node, walls: every point the cursor passed since the last tick, then where it is now
+    if (mouseLeftDown || mouseRightDown)
+    {
+        strokePixels.push_back(sf::Mouse::getPosition(window));
+        for (sf::Vector2i pixel : strokePixels)
+            HandleTileClick(window.mapPixelToCoords(pixel, camera));
+    }
+    strokePixels.clear();
 
-    // remove walls:
-    if (mouseRightDown)
-        HandleTileClick();
+    // worker progress since last tick, never waits on the worker:
+    bool progress = DrainWorker();
 
     // A* visualisation..
-    if (algorithmStart)
-        AStarAlgorithm();
+    bool searched = false;
+    if (livePath)
+    {
+        // the live path is always current, visualise has nothing to start:
+        algorithmStart = false;
+        progress = UpdateLivePath() || progress;
+    }
+    else if (algorithmStart)
+    {
+        RunSearch();
+        searched = true;
+    }
+    else if (steppedSearch.Running())
+    {
+        StepSearch();
+        searched = true;
+    }
+
+    if (searched || progress || grid.version != version || startCell != start || endCell != end)
+        redraw = true;
+}
+
+sf::Color TileColour(int cell, bool onPath, const SearchContext* searched)
+{
+    if (cell == startCell)
+        return sf::Color::Green;
+    if (cell == endCell)
+        return sf::Color::Red;
+    if (onPath)
+        return sf::Color::Yellow;      // path between start + end
+    if (grid.obstacle[cell])
+        return sf::Color::Black;
+    if (searched && searched->IsReached(cell))
+        return sf::Color::Magenta;     // searched cells
+    return sf::Color::White;
+}
+
+void RenderTiles(const SearchContext* searched)
+{
+    // only tiles in view are coloured + drawn, however big the grid:
+    if (!gridRenderer.Cull(camera))
+        std::cerr << "can't create vertex buffers for the tiles in view\n";
+    const GridRenderer::Window& visible = gridRenderer.Visible();
+
+    // every tile gets its final colour in one go, so only real changes are uploaded:
+    pathMarks.assign(static_cast<std::size_t>(visible.Width()) * visible.Height(), 0);
+    for (int cell : path)
+    {
+        int x = grid.X(cell);
+        int y = grid.Y(cell);
+        if (x >= visible.left && x < visible.right && y >= visible.top && y < visible.bottom)
+            pathMarks[(x - visible.left) + visible.Width() * (y - visible.top)] = 1;
+    }
+
+    // colour tiles from grid + search state:
+    for (int slot = 0; slot < static_cast<int>(pathMarks.size()); slot++)
+    {
+        int x = visible.left + slot % visible.Width();
+        int y = visible.top + slot / visible.Width();
+        gridRenderer.SetColour(x, y, TileColour(grid.Index(x, y), pathMarks[slot] != 0, searched));
+    }
+
+    // display grid, changed tiles only:
+    gridRenderer.Upload();
+    gridRenderer.Draw(window);
+}
+
+void RenderTexture(const SearchContext* searched)
+{
+    std::vector<int> sortedPath(path);
+    std::sort(sortedPath.begin(), sortedPath.end());
+    auto refresh = [&](int cell)
+    {
+        if (cell >= 0)
+            gridTexture.SetColour(cell, TileColour(cell,
+                std::binary_search(sortedPath.begin(), sortedPath.end(), cell), searched));
+    };
+
+    // cells known to have changed, straight away:
+    for (int cell : changedCells)
+        refresh(cell);
+    for (int cell : drawnPath)
+        refresh(cell);
+    for (int cell : sortedPath)
+        refresh(cell);
+    for (int cell : { drawnStart, drawnEnd, startCell, endCell })
+        refresh(cell);
+
+    // different search shown, any cell could have changed:
+    if (searched != drawnSearched)
+        sweepRows = grid.height;
+
+    // the rest, a budget of rows per frame:
+    int rows = sweepAll ? grid.height : std::min(sweepRows, std::max(1, SWEEP_CELLS / grid.width));
+    for (int i = 0; i < rows; i++)
+    {
+        int first = grid.Index(0, sweepRow);
+        auto onPath = std::lower_bound(sortedPath.begin(), sortedPath.end(), first);
+        for (int cell = first; cell < first + grid.width; cell++)
+        {
+            while (onPath != sortedPath.end() && *onPath < cell)
+                ++onPath;
+            gridTexture.SetColour(cell, TileColour(cell,
+                onPath != sortedPath.end() && *onPath == cell, searched));
+        }
+        sweepRow = (sweepRow + 1) % grid.height;
+    }
+    sweepRows = std::max(0, sweepRows - rows);
+    sweepAll = false;
+    if (sweepRows > 0)
+        redraw = true;      // not caught up yet, another frame even if nothing else changes
+
+    drawnPath.swap(sortedPath);
+    drawnStart = startCell;
+    drawnEnd = endCell;
+    drawnSearched = searched;
+
+    // display grid, changed rectangles only:
+    gridTexture.Upload();
+    gridTexture.Draw(window);
 }
 
 void Render()
 {
     /* Render */
-    window.clear(sf::Color::Blue);
+    window.clear(BACKGROUND);
+    window.setView(camera);
 
-    // display grid:
-    for (const auto& row : nodes)
-        window.draw(row.tile);
+    // search state of whichever search produced the path:
+    const SearchContext& context = livePath && planner ? planner->Context() : searchContext;
+    bool showSearched = static_cast<int>(context.visited.size()) == grid.Size();
+    const SearchContext* searched = showSearched ? &context : nullptr;
+
+    if (renderMode == RenderMode::Texture)
+        RenderTexture(searched);
+    else
+        RenderTiles(searched);
+    changedCells.clear();
 
     ImGui::SFML::Render(window);
     window.display();
-}
\ No newline at end of file
+}
@@ -0,0 +1,491 @@
+#include "AStar.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "Hierarchy.h"
+#include "Landmarks.h"
+#include "MapFile.h"
+#include "PathDatabase.h"
+#include "QueryPool.h"
+#include "SearchContext.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Benchmark driver:
+ *   pathfinding-bench [--format csv|json] [--engines astar,jps,bidir,octile,hpa,alt] [--hpa <cluster size>]
+ *                     [--alt <landmarks>] [--alt-file <file>] [--cpd-file <file>] [--threads <max>]
+ *                     <map file> <scenario file>
+ * runs every scenario through each engine, prints one summary per engine:
+ * latency percentiles, nodes expanded and path cost against the
+ * scenario's optimal length.
+ * with --threads, prints batch throughput per worker count instead.
+ */
+
+static void PrintUsage()
+{
+    std::cerr << "usage: pathfinding-bench [--format csv|json] [--engines astar,jps,bidir,octile,hpa,alt]"
+        << " [--hpa <cluster size>] [--alt <landmarks>] [--alt-file <file>] [--cpd-file <file>] [--threads <max>]"
+        << " <map file> <scenario file>\n"
+        << "  --format    output format (default: csv)\n"
+        << "  --engines   comma separated engines to run (default: all)\n"
+        << "  --hpa       cluster size for the hpa engine (default: " << Hierarchy::DEFAULT_CLUSTER_SIZE << ")\n"
+        << "  --alt       landmark count for the alt engine (default: 8)\n"
+        << "  --alt-file  landmark tables, loaded if built for this map, else built + saved\n"
+        << "  --cpd-file  path database for the cpd engine (not run by default), same as above\n"
+        << "  --threads   measure batch throughput on 1, 2, 4 .. max workers\n"
+        << "  map file    Moving AI .map\n"
+        << "  scenario    Moving AI .scen for that map\n";
+}
+
+// one engine under test, preprocessing done before the clock starts:
+struct Bench
+{
+    std::string name;
+    std::function<SearchResult(SearchContext&, int, int)> run;
+    double buildMillis = 0.0;
+};
+
+// totals over every scenario for one engine:
+struct Summary
+{
+    std::string engine;
+    std::size_t queries = 0;
+    std::size_t found = 0;
+    std::size_t optimal = 0;    // cost matches the scenario
+    std::size_t shorter = 0;    // cheaper, only by cutting corners
+    std::size_t longer = 0;     // suboptimal or not found
+    double p50 = 0.0;
+    double p90 = 0.0;
+    double p99 = 0.0;
+    double maxMicros = 0.0;
+    double meanMicros = 0.0;
+    double meanExpanded = 0.0;
+    double maxError = 0.0;      // worst cost / optimal - 1 above optimal
+    double buildMillis = 0.0;
+};
+
+// batch throughput of one engine at one worker count:
+struct Scaling
+{
+    std::string engine;
+    unsigned threads = 0;
+    std::size_t queries = 0;
+    double seconds = 0.0;
+    double queriesPerSecond = 0.0;
+    double speedup = 0.0;       // over a single worker
+};
+
+// nearest-rank percentile of sorted values:
+static double Percentile(const std::vector<double>& sorted, double percent)
+{
+    if (sorted.empty())
+        return 0.0;
+    std::size_t rank = static_cast<std::size_t>(std::ceil(percent / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<std::size_t>(rank, 1)) - 1];
+}
+
+static Summary RunBench(
+    const Bench& bench,
+    const Grid& grid,
+    SearchContext& context,
+    const std::vector<Scenario>& scenarios)
+{
+    Summary summary;
+    summary.engine = bench.name;
+    summary.buildMillis = bench.buildMillis;
+
+    std::vector<double> micros;
+    micros.reserve(scenarios.size());
+    double totalExpanded = 0.0;
+
+    for (const auto& scenario : scenarios)
+    {
+        int startCell = grid.Index(scenario.startX, scenario.startY);
+        int endCell = grid.Index(scenario.endX, scenario.endY);
+
+        auto begin = std::chrono::steady_clock::now();
+        SearchResult result = bench.run(context, startCell, endCell);
+        auto end = std::chrono::steady_clock::now();
+
+        micros.push_back(std::chrono::duration<double, std::micro>(end - begin).count());
+        totalExpanded += static_cast<double>(result.expanded);
+        summary.queries++;
+
+        // costs are summed in float, scenario lengths in double:
+        double tolerance = scenario.optimalLength * 1e-5 + 1e-3;
+        double error = result.cost - scenario.optimalLength;
+        if (!result.found)
+            summary.longer++;
+        else if (error > tolerance)
+            summary.longer++;
+        else if (error < -tolerance)
+            summary.shorter++;
+        else
+            summary.optimal++;
+
+        if (result.found)
+        {
+            summary.found++;
+            if (scenario.optimalLength > 0.0)
+                summary.maxError = std::max(summary.maxError, error / scenario.optimalLength);
+        }
+    }
+
+    std::sort(micros.begin(), micros.end());
+    summary.p50 = Percentile(micros, 50.0);
+    summary.p90 = Percentile(micros, 90.0);
+    summary.p99 = Percentile(micros, 99.0);
+    if (!micros.empty())
+    {
+        summary.maxMicros = micros.back();
+        double total = 0.0;
+        for (double value : micros)
+            total += value;
+        summary.meanMicros = total / micros.size();
+        summary.meanExpanded = totalExpanded / micros.size();
+    }
+    return summary;
+}
+
+static std::vector<Scaling> RunScaling(
+    const Bench& bench,
+    const Grid& grid,
+    const std::vector<Query>& queries,
+    unsigned maxThreads)
+{
+    // doubling worker counts, always ending on maxThreads:
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2)
+        counts.push_back(threads);
+    counts.push_back(maxThreads);
+
+    std::vector<Scaling> rows;
+    for (unsigned threads : counts)
+    {
+        QueryPool pool(grid, threads);
+
+        auto begin = std::chrono::steady_clock::now();
+        pool.Solve(bench.run, queries.data(), queries.size());
+        auto end = std::chrono::steady_clock::now();
+
+        Scaling row;
+        row.engine = bench.name;
+        row.threads = threads;
+        row.queries = queries.size();
+        row.seconds = std::chrono::duration<double>(end - begin).count();
+        row.queriesPerSecond = row.seconds > 0.0 ? queries.size() / row.seconds : 0.0;
+        row.speedup = rows.empty() || row.seconds <= 0.0 ? 1.0 : rows.front().seconds / row.seconds;
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+static void PrintCsv(const std::vector<Summary>& summaries)
+{
+    std::cout << "engine,queries,found,optimal,shorter,longer,"
+        << "p50_us,p90_us,p99_us,max_us,mean_us,mean_expanded,max_error,build_ms\n"
+        << std::fixed;
+    for (const auto& s : summaries)
+    {
+        std::cout << s.engine << ',' << s.queries << ',' << s.found << ','
+            << s.optimal << ',' << s.shorter << ',' << s.longer << ','
+            << std::setprecision(2) << s.p50 << ',' << s.p90 << ',' << s.p99 << ','
+            << s.maxMicros << ',' << s.meanMicros << ',' << s.meanExpanded << ','
+            << std::setprecision(6) << s.maxError << ','
+            << std::setprecision(2) << s.buildMillis << '\n';
+    }
+}
+
+static void PrintJson(const std::vector<Summary>& summaries)
+{
+    std::cout << "[\n" << std::fixed;
+    for (std::size_t i = 0; i < summaries.size(); i++)
+    {
+        const auto& s = summaries[i];
+        std::cout << "  { \"engine\": \"" << s.engine << "\""
+            << ", \"queries\": " << s.queries
+            << ", \"found\": " << s.found
+            << ", \"optimal\": " << s.optimal
+            << ", \"shorter\": " << s.shorter
+            << ", \"longer\": " << s.longer
+            << std::setprecision(2)
+            << ", \"p50_us\": " << s.p50
+            << ", \"p90_us\": " << s.p90
+            << ", \"p99_us\": " << s.p99
+            << ", \"max_us\": " << s.maxMicros
+            << ", \"mean_us\": " << s.meanMicros
+            << ", \"mean_expanded\": " << s.meanExpanded
+            << std::setprecision(6)
+            << ", \"max_error\": " << s.maxError
+            << std::setprecision(2)
+            << ", \"build_ms\": " << s.buildMillis
+            << " }" << (i + 1 < summaries.size() ? "," : "") << '\n';
+    }
+    std::cout << "]\n";
+}
+
+static void PrintScalingCsv(const std::vector<Scaling>& rows)
+{
+    std::cout << "engine,threads,queries,seconds,queries_per_sec,speedup\n" << std::fixed;
+    for (const auto& row : rows)
+    {
+        std::cout << row.engine << ',' << row.threads << ',' << row.queries << ','
+            << std::setprecision(4) << row.seconds << ','
+            << std::setprecision(1) << row.queriesPerSecond << ','
+            << std::setprecision(2) << row.speedup << '\n';
+    }
+}
+
+static void PrintScalingJson(const std::vector<Scaling>& rows)
+{
+    std::cout << "[\n" << std::fixed;
+    for (std::size_t i = 0; i < rows.size(); i++)
+    {
+        const auto& row = rows[i];
+        std::cout << "  { \"engine\": \"" << row.engine << "\""
+            << ", \"threads\": " << row.threads
+            << ", \"queries\": " << row.queries
+            << std::setprecision(4)
+            << ", \"seconds\": " << row.seconds
+            << std::setprecision(1)
+            << ", \"queries_per_sec\": " << row.queriesPerSecond
+            << std::setprecision(2)
+            << ", \"speedup\": " << row.speedup
+            << " }" << (i + 1 < rows.size() ? "," : "") << '\n';
+    }
+    std::cout << "]\n";
+}
+
+int main(int argc, char* argv[])
+{
+    std::string format = "csv";
+    std::string engineList = "astar,jps,bidir,octile,hpa,alt";
+    int clusterSize = Hierarchy::DEFAULT_CLUSTER_SIZE;
+    int landmarkCount = 8;
+    std::string landmarkFile;
+    std::string databaseFile;
+    int maxThreads = 0;     // 0 = latency summary, no throughput sweep
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc)
+            format = argv[++i];
+        else if (arg == "--engines" && i + 1 < argc)
+            engineList = argv[++i];
+        else if (arg == "--hpa" && i + 1 < argc)
+        {
+            clusterSize = std::atoi(argv[++i]);
+            if (clusterSize <= 0)
+            {
+                std::cerr << "bad cluster size: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--alt" && i + 1 < argc)
+        {
+            landmarkCount = std::atoi(argv[++i]);
+            if (landmarkCount <= 0)
+            {
+                std::cerr << "bad landmark count: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--alt-file" && i + 1 < argc)
+            landmarkFile = argv[++i];
+        else if (arg == "--cpd-file" && i + 1 < argc)
+            databaseFile = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            maxThreads = std::atoi(argv[++i]);
+            if (maxThreads <= 0)
+            {
+                std::cerr << "bad thread count: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else
+            files.push_back(arg);
+    }
+
+    if (files.size() != 2 || (format != "csv" && format != "json"))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    Grid grid{ 0, 0 };
+    if (!LoadMap(files[0], grid))
+    {
+        std::cerr << "can't load map: " << files[0] << "\n";
+        return 1;
+    }
+
+    std::vector<Scenario> scenarios;
+    if (!LoadScenarios(files[1], scenarios))
+    {
+        std::cerr << "can't load scenarios: " << files[1] << "\n";
+        return 1;
+    }
+
+    // scenarios written for another map size can't be trusted:
+    auto mismatched = std::remove_if(scenarios.begin(), scenarios.end(),
+        [&](const Scenario& s)
+        {
+            return s.mapWidth != grid.width || s.mapHeight != grid.height ||
+                s.startX < 0 || s.startY < 0 || s.startX >= grid.width || s.startY >= grid.height ||
+                s.endX < 0 || s.endY < 0 || s.endX >= grid.width || s.endY >= grid.height;
+        });
+    if (mismatched != scenarios.end())
+    {
+        std::cerr << "skipping " << (scenarios.end() - mismatched)
+            << " scenarios that don't fit the map\n";
+        scenarios.erase(mismatched, scenarios.end());
+    }
+
+    std::vector<Bench> benches;
+    std::unique_ptr<Hierarchy> hierarchy;
+    std::unique_ptr<Landmarks> landmarks;
+    std::unique_ptr<PathDatabase> database;
+
+    std::stringstream names(engineList);
+    std::string name;
+    while (std::getline(names, name, ','))
+    {
+        Engine engine;
+        if (ParseEngine(name, engine))
+        {
+            benches.push_back({ name, [&grid, engine](SearchContext& context, int start, int end)
+                {
+                    return FindPath(engine, grid, context, start, end);
+                } });
+        }
+        else if (name == "hpa")
+        {
+            if (hierarchy)
+                continue;
+
+            auto begin = std::chrono::steady_clock::now();
+            hierarchy = std::make_unique<Hierarchy>(grid, clusterSize);
+            auto end = std::chrono::steady_clock::now();
+
+            const Hierarchy& built = *hierarchy;
+            benches.push_back({ name, [&built](SearchContext& context, int start, int end)
+                {
+                    return built.FindPath(context, start, end);
+                },
+                std::chrono::duration<double, std::milli>(end - begin).count() });
+        }
+        else if (name == "alt")
+        {
+            if (landmarks)
+                continue;
+
+            // tables from an earlier run cost no preprocessing:
+            auto begin = std::chrono::steady_clock::now();
+            landmarks = std::make_unique<Landmarks>(grid);
+            if (landmarkFile.empty() || !landmarks->Load(landmarkFile))
+            {
+                landmarks->Build(landmarkCount);
+                if (!landmarkFile.empty() && !landmarks->Save(landmarkFile))
+                    std::cerr << "can't save landmarks: " << landmarkFile << "\n";
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            const Landmarks& built = *landmarks;
+            benches.push_back({ name, [&grid, &built](SearchContext& context, int start, int end)
+                {
+                    return AStarAlgorithm(grid, context, start, end, built);
+                },
+                std::chrono::duration<double, std::milli>(end - begin).count() });
+        }
+        else if (name == "cpd")
+        {
+            if (database)
+                continue;
+
+            // one Dijkstra per cell, worth keeping between runs:
+            auto begin = std::chrono::steady_clock::now();
+            database = std::make_unique<PathDatabase>(grid);
+            if (databaseFile.empty() || !database->Load(databaseFile))
+            {
+                std::cerr << "building path database over " << grid.Size() << " cells...\n";
+                database->Build();
+                if (!databaseFile.empty() && !database->Save(databaseFile))
+                    std::cerr << "can't save path database: " << databaseFile << "\n";
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            const PathDatabase& built = *database;
+            benches.push_back({ name, [&built](SearchContext&, int start, int end)
+                {
+                    return built.FindPath(start, end);
+                },
+                std::chrono::duration<double, std::milli>(end - begin).count() });
+        }
+        else
+        {
+            std::cerr << "unknown engine: " << name << "\n";
+            return 1;
+        }
+    }
+
+    if (maxThreads > 0)
+    {
+        std::vector<Query> queries;
+        for (const auto& s : scenarios)
+            queries.push_back({ grid.Index(s.startX, s.startY), grid.Index(s.endX, s.endY) });
+
+        std::vector<Scaling> rows;
+        for (const auto& bench : benches)
+        {
+            std::cerr << "running " << bench.name << " on up to "
+                << maxThreads << " workers...\n";
+            auto benchRows = RunScaling(bench, grid, queries, static_cast<unsigned>(maxThreads));
+            rows.insert(rows.end(), benchRows.begin(), benchRows.end());
+        }
+
+        if (format == "json")
+            PrintScalingJson(rows);
+        else
+            PrintScalingCsv(rows);
+        return 0;
+    }
+
+    SearchContext context{ grid.Size() };
+
+    std::vector<Summary> summaries;
+    for (const auto& bench : benches)
+    {
+        std::cerr << "running " << bench.name << " over "
+            << scenarios.size() << " scenarios...\n";
+        summaries.push_back(RunBench(bench, grid, context, scenarios));
+    }
+
+    // same search, only the heuristic differs:
+    auto astar = std::find_if(summaries.begin(), summaries.end(),
+        [](const Summary& s) { return s.engine == "astar"; });
+    auto alt = std::find_if(summaries.begin(), summaries.end(),
+        [](const Summary& s) { return s.engine == "alt"; });
+    if (astar != summaries.end() && alt != summaries.end() && astar->meanExpanded > 0.0)
+    {
+        std::cerr << "alt expands " << std::fixed << std::setprecision(1)
+            << 100.0 * (1.0 - alt->meanExpanded / astar->meanExpanded)
+            << "% fewer cells than astar (euclidean)\n";
+    }
+
+    if (format == "json")
+        PrintJson(summaries);
+    else
+        PrintCsv(summaries);
+    return 0;
+}
@@ -0,0 +1,216 @@
+#include "AStar.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "Hierarchy.h"
+#include "Landmarks.h"
+#include "MapFile.h"
+#include "PathDatabase.h"
+#include "SearchContext.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/* Headless driver:
+ *   pathfinding-cli [--engine astar|jps|bidir|octile] [--hpa <cluster size>]
+ *                   [--alt <landmarks>] [--alt-file <file>] [--cpd <file>] <map file> [query file]
+ * each query line is "startX startY endX endY", read from the query
+ * file or stdin. prints one result line per query.
+ */
+
+static void PrintUsage()
+{
+    std::cerr << "usage: pathfinding-cli [--engine astar|jps|bidir|octile] [--hpa <cluster size>]"
+        << " [--alt <landmarks>] [--alt-file <file>] [--cpd <file>] <map file> [query file]\n"
+        << "  --engine    search engine (default: astar)\n"
+        << "  --hpa       hierarchical search over clusters of this size, overrides --engine\n"
+        << "  --alt       A* with a landmark heuristic over this many landmarks, overrides --engine\n"
+        << "  --alt-file  landmark tables, loaded if built for this map, else built + saved\n"
+        << "  --cpd       read paths from a path database, loaded or built + saved like --alt-file\n"
+        << "  map file    Moving AI .map\n"
+        << "  query file  one \"startX startY endX endY\" per line (default: stdin)\n";
+}
+
+static bool ParseQuery(const std::string& line, int& sx, int& sy, int& ex, int& ey)
+{
+    std::istringstream stream(line);
+    return static_cast<bool>(stream >> sx >> sy >> ex >> ey);
+}
+
+int main(int argc, char* argv[])
+{
+    Engine engine = Engine::AStar;
+    int clusterSize = 0;    // 0 = no hierarchy
+    int landmarkCount = 0;  // 0 = euclidean heuristic
+    std::string landmarkFile;
+    std::string databaseFile;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--engine" && i + 1 < argc)
+        {
+            if (!ParseEngine(argv[++i], engine))
+            {
+                std::cerr << "unknown engine: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--hpa" && i + 1 < argc)
+        {
+            clusterSize = std::atoi(argv[++i]);
+            if (clusterSize <= 0)
+            {
+                std::cerr << "bad cluster size: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--alt" && i + 1 < argc)
+        {
+            landmarkCount = std::atoi(argv[++i]);
+            if (landmarkCount <= 0)
+            {
+                std::cerr << "bad landmark count: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (arg == "--alt-file" && i + 1 < argc)
+            landmarkFile = argv[++i];
+        else if (arg == "--cpd" && i + 1 < argc)
+            databaseFile = argv[++i];
+        else
+            files.push_back(arg);
+    }
+
+    if (files.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    Grid grid{ 0, 0 };
+    if (!LoadMap(files[0], grid))
+    {
+        std::cerr << "can't load map: " << files[0] << "\n";
+        return 1;
+    }
+
+    std::ifstream queryFile;
+    if (files.size() > 1)
+    {
+        queryFile.open(files[1]);
+        if (!queryFile)
+        {
+            std::cerr << "can't open queries: " << files[1] << "\n";
+            return 1;
+        }
+    }
+    std::istream& queries = files.size() > 1 ? queryFile : std::cin;
+
+    SearchContext context{ grid.Size() };
+
+    // preprocessing, reported separately from the queries:
+    std::unique_ptr<Hierarchy> hierarchy;
+    if (clusterSize > 0)
+    {
+        auto begin = std::chrono::steady_clock::now();
+        hierarchy = std::make_unique<Hierarchy>(grid, clusterSize);
+        auto end = std::chrono::steady_clock::now();
+
+        std::cerr << hierarchy->ClusterCount() << " clusters built in "
+            << std::fixed << std::setprecision(1)
+            << std::chrono::duration<double, std::milli>(end - begin).count() << " ms\n";
+    }
+
+    // a saved table skips the Dijkstra runs:
+    std::unique_ptr<Landmarks> landmarks;
+    if (landmarkCount > 0 || !landmarkFile.empty())
+    {
+        auto begin = std::chrono::steady_clock::now();
+        landmarks = std::make_unique<Landmarks>(grid);
+        bool loaded = !landmarkFile.empty() && landmarks->Load(landmarkFile);
+        if (!loaded)
+        {
+            landmarks->Build(landmarkCount > 0 ? landmarkCount : 8);
+            if (!landmarkFile.empty() && !landmarks->Save(landmarkFile))
+                std::cerr << "can't save landmarks: " << landmarkFile << "\n";
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        std::cerr << landmarks->Count() << " landmarks " << (loaded ? "loaded" : "built") << " in "
+            << std::fixed << std::setprecision(1)
+            << std::chrono::duration<double, std::milli>(end - begin).count() << " ms\n";
+    }
+
+    // one Dijkstra per cell to build, meant to be loaded from disk:
+    std::unique_ptr<PathDatabase> database;
+    if (!databaseFile.empty())
+    {
+        auto begin = std::chrono::steady_clock::now();
+        database = std::make_unique<PathDatabase>(grid);
+        bool loaded = database->Load(databaseFile);
+        if (!loaded)
+        {
+            database->Build();
+            if (!database->Save(databaseFile))
+                std::cerr << "can't save path database: " << databaseFile << "\n";
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        std::cerr << database->RunCount() << " runs " << (loaded ? "loaded" : "built") << " in "
+            << std::fixed << std::setprecision(1)
+            << std::chrono::duration<double, std::milli>(end - begin).count() << " ms\n";
+    }
+
+    std::cout << "startX startY endX endY found cost length expanded expanded_back time_us\n"
+        << std::fixed;
+
+    std::string line;
+    int queryCount = 0;
+    double totalMicros = 0.0;
+    while (std::getline(queries, line))
+    {
+        int sx, sy, ex, ey;
+        if (line.empty() || line[0] == '#')
+            continue;
+        if (!ParseQuery(line, sx, sy, ex, ey) ||
+            sx < 0 || sy < 0 || sx >= grid.width || sy >= grid.height ||
+            ex < 0 || ey < 0 || ex >= grid.width || ey >= grid.height)
+        {
+            std::cerr << "skipping bad query: " << line << "\n";
+            continue;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        SearchResult result = database
+            ? database->FindPath(grid.Index(sx, sy), grid.Index(ex, ey))
+            : hierarchy
+            ? hierarchy->FindPath(context, grid.Index(sx, sy), grid.Index(ex, ey))
+            : landmarks
+            ? AStarAlgorithm(grid, context, grid.Index(sx, sy), grid.Index(ex, ey), *landmarks)
+            : FindPath(engine, grid, context, grid.Index(sx, sy), grid.Index(ex, ey));
+        auto end = std::chrono::steady_clock::now();
+
+        double micros = std::chrono::duration<double, std::micro>(end - begin).count();
+        totalMicros += micros;
+        queryCount++;
+
+        std::cout << sx << ' ' << sy << ' ' << ex << ' ' << ey << ' '
+            << (result.found ? 1 : 0) << ' '
+            << std::setprecision(4) << result.cost << ' '
+            << result.path.size() << ' '
+            << result.expanded << ' '
+            << result.expandedBackward << ' '
+            << std::setprecision(1) << micros << '\n';
+    }
+
+    std::cerr << queryCount << " queries, "
+        << std::fixed << std::setprecision(1) << totalMicros / 1000.0 << " ms total\n";
+    return 0;
+}
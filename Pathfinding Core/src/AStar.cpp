@@ -0,0 +1,159 @@
+#include "AStar.h"
+#include "Landmarks.h"
+
+#include <algorithm>
+
+namespace
+{
+    struct LandmarkHeuristic
+    {
+        const Landmarks& landmarks;
+        float operator()(int cell, int endCell) const { return landmarks.Heuristic(cell, endCell); }
+    };
+
+    template <typename Heuristic>
+    SearchResult Search(
+        const Grid& grid,
+        SearchContext& context,
+        int startCell,
+        int endCell,
+        TieBreak tieBreak,
+        Heuristic distance)
+    {
+        SearchResult result;
+
+        // forget previous search in O(1):
+        context.NewSearch();
+
+        auto& ctx = context;
+        ctx.parent[startCell] = -1;
+        ctx.gcost[startCell] = 0.0f;
+        ctx.hcost[startCell] = distance(startCell, endCell);
+        ctx.fcost[startCell] = ctx.hcost[startCell];
+
+        // cells to test, cheapest on top:
+        OpenList openList(ctx, tieBreak);
+        ctx.Open(startCell);
+        openList.Push(startCell);
+
+        while (!openList.Empty())
+        {
+            int currentCell = ExpandNext(grid, ctx, openList, endCell, distance);
+            result.expanded++;
+
+            // end goal reached:
+            if (currentCell == endCell)
+            {
+                result.found = true;
+                result.cost = ctx.gcost[endCell];
+                result.path = RetracePath(ctx, endCell);
+                return result;
+            }
+        }
+
+        // open list exhausted, no path:
+        return result;
+    }
+}
+
+SearchResult AStarAlgorithm(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak)
+{
+    return Search(grid, context, startCell, endCell, tieBreak, EuclideanHeuristic{ grid });
+}
+
+SearchResult AStarAlgorithm(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    const Landmarks& landmarks,
+    TieBreak tieBreak)
+{
+    return Search(grid, context, startCell, endCell, tieBreak, LandmarkHeuristic{ landmarks });
+}
+
+void Dijkstra(const Grid& grid, SearchContext& context, int sourceCell)
+{
+    context.NewSearch();
+
+    // open list ordered by gcost alone:
+    OpenList openList(context, TieBreak::FirstIn);
+    context.parent[sourceCell] = -1;
+    context.gcost[sourceCell] = 0.0f;
+    context.hcost[sourceCell] = 0.0f;
+    context.fcost[sourceCell] = 0.0f;
+    context.Open(sourceCell);
+    openList.Push(sourceCell);
+
+    while (!openList.Empty())
+    {
+        int currentCell = openList.Pop();
+        context.Close(currentCell);
+
+        for (int neighbour : grid.Neighbours(currentCell))
+        {
+            if (grid.obstacle[neighbour] ||
+                context.IsClosed(neighbour))
+                continue;
+
+            float costToMove =
+                context.gcost[currentCell] + grid.Distance(currentCell, neighbour);
+
+            bool inOpenList = context.IsOpen(neighbour);
+            if (costToMove < context.gcost[neighbour] || !inOpenList)
+            {
+                context.parent[neighbour] = currentCell;
+                context.gcost[neighbour] = costToMove;
+                context.hcost[neighbour] = 0.0f;
+                context.fcost[neighbour] = costToMove;
+
+                if (inOpenList)
+                    openList.DecreaseKey(neighbour);
+                else
+                {
+                    context.Open(neighbour);
+                    openList.Push(neighbour);
+                }
+            }
+        }
+    }
+}
+
+std::vector<int> RetracePath(const SearchContext& context, int endCell)
+{
+    std::vector<int> path;
+
+    // continue to update tracker to current cell's parent until start cell is reached:
+    for (int tracker = endCell; tracker != -1; tracker = context.parent[tracker])
+        path.push_back(tracker);
+
+    std::reverse(path.begin(), path.end());
+    return path;
+}
+
+std::vector<int> RetracePath(
+    const SearchContext& forward,
+    const SearchContext& backward,
+    int meetCell)
+{
+    std::vector<int> path = RetracePath(forward, meetCell);
+
+    // backward parents point towards the end cell:
+    for (int tracker = backward.parent[meetCell]; tracker != -1; tracker = backward.parent[tracker])
+        path.push_back(tracker);
+
+    return path;
+}
+
+float PathCost(const Grid& grid, const std::vector<int>& path)
+{
+    float cost = 0.0f;
+    for (std::size_t i = 1; i < path.size(); i++)
+        cost += grid.Distance(path[i - 1], path[i]);
+    return cost;
+}
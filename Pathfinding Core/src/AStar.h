@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <cstddef>
+#include <vector>
+
+class Landmarks;
+
+// outcome of a single start -> end query:
+struct SearchResult
+{
+    bool found = false;
+    float cost = 0.0f;                  // path cost, in cells
+    std::vector<int> path;              // start -> end, inclusive
+    std::size_t expanded = 0;           // cells taken off the open list
+    std::size_t expandedBackward = 0;   // of which from the end side (bidirectional only)
+};
+
+/* Main Algorithm:
+ * A* from startCell to endCell over grid, search state is written
+ * into context (sized to grid) and left there for inspection.
+ */
+SearchResult AStarAlgorithm(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak = TieBreak::LastIn);
+
+// same search guided by the landmark (ALT) heuristic, built for the same walls:
+SearchResult AStarAlgorithm(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    const Landmarks& landmarks,
+    TieBreak tieBreak = TieBreak::LastIn);
+
+// straight line lower bound on the cost from a cell to the end cell, AStarAlgorithm()'s default:
+struct EuclideanHeuristic
+{
+    const Grid& grid;
+    float operator()(int cell, int endCell) const { return grid.Distance(cell, endCell); }
+};
+
+/* One A* expansion, shared by every A* that must expand in the same
+ * order as AStarAlgorithm() (ResumableSearch steps through it):
+ * takes the cheapest cell off openList, closes it and, unless it's
+ * endCell, relaxes its neighbours. returns the cell. openList must not
+ * be empty.
+ * order in which neighbours are processed:
+ * top, right, bottom, left, top-left, top-right, bottom-right, bottom-left.
+ */
+template <typename Heuristic>
+int ExpandNext(const Grid& grid, SearchContext& ctx, OpenList& openList, int endCell, Heuristic distance)
+{
+    // remove lowest fcost cell from openlist and close it:
+    int currentCell = openList.Pop();
+    ctx.Close(currentCell);
+    if (currentCell == endCell)
+        return currentCell;
+
+    for (int neighbour : grid.Neighbours(currentCell))
+    {
+        if (grid.obstacle[neighbour] ||
+            ctx.IsClosed(neighbour))
+            continue;
+
+        float costToMove =
+            ctx.gcost[currentCell] + grid.Distance(currentCell, neighbour);
+
+        bool inOpenList = ctx.IsOpen(neighbour);
+        if (costToMove < ctx.gcost[neighbour] || !inOpenList)
+        {
+            ctx.parent[neighbour] = currentCell;
+            ctx.gcost[neighbour] = costToMove;
+            ctx.hcost[neighbour] = distance(neighbour, endCell);
+            ctx.fcost[neighbour] = ctx.gcost[neighbour] + ctx.hcost[neighbour];
+
+            if (inOpenList)
+                openList.DecreaseKey(neighbour);
+            else
+            {
+                ctx.Open(neighbour);
+                openList.Push(neighbour);
+            }
+        }
+    }
+    return currentCell;
+}
+
+/* exact distance from sourceCell to every cell it can reach, left in
+ * context: reached cells are closed, with gcost + parent set.
+ */
+void Dijkstra(const Grid& grid, SearchContext& context, int sourceCell);
+
+// Path generated by a search, following parents back from endCell:
+std::vector<int> RetracePath(const SearchContext& context, int endCell);
+
+// Path stitched together at meetCell, forward parents to the start, backward parents to the end:
+std::vector<int> RetracePath(
+    const SearchContext& forward,
+    const SearchContext& backward,
+    int meetCell);
+
+// sum of step distances along a path:
+float PathCost(const Grid& grid, const std::vector<int>& path);
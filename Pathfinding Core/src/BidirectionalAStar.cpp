@@ -0,0 +1,124 @@
+#include "BidirectionalAStar.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    // one direction of the search, target = cell its heuristic aims at:
+    struct Frontier
+    {
+        SearchContext& ctx;
+        OpenList openList;
+        int target;
+    };
+}
+
+SearchResult BidirectionalAStar(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak)
+{
+    SearchResult result;
+
+    // forgets both sides:
+    context.NewSearch();
+
+    if (startCell == endCell)
+    {
+        result.found = true;
+        result.path.push_back(startCell);
+        return result;
+    }
+
+    // walls are never entered, the end cell included:
+    if (grid.obstacle[endCell])
+        return result;
+
+    Frontier forward{ context, OpenList(context, tieBreak), endCell };
+    Frontier backward{ context.Backward(), OpenList(context.Backward(), tieBreak), startCell };
+
+    for (Frontier* side : { &forward, &backward })
+    {
+        int cell = side == &forward ? startCell : endCell;
+        auto& ctx = side->ctx;
+        ctx.parent[cell] = -1;
+        ctx.gcost[cell] = 0.0f;
+        ctx.hcost[cell] = grid.Distance(cell, side->target);
+        ctx.fcost[cell] = ctx.hcost[cell];
+        ctx.Open(cell);
+        side->openList.Push(cell);
+    }
+
+    // cheapest start -> end path seen so far, through meetCell:
+    float best = std::numeric_limits<float>::infinity();
+    int meetCell = -1;
+
+    while (!forward.openList.Empty() && !backward.openList.Empty())
+    {
+        // neither side can find anything cheaper:
+        float bound = std::max(
+            forward.ctx.fcost[forward.openList.Top()],
+            backward.ctx.fcost[backward.openList.Top()]);
+        if (bound >= best)
+            break;
+
+        // grow the smaller frontier:
+        bool isForward = forward.openList.Size() <= backward.openList.Size();
+        Frontier& side = isForward ? forward : backward;
+        const SearchContext& other = isForward ? backward.ctx : forward.ctx;
+        auto& ctx = side.ctx;
+
+        int currentCell = side.openList.Pop();
+        ctx.Close(currentCell);
+        result.expanded++;
+        if (!isForward)
+            result.expandedBackward++;
+
+        for (int neighbour : grid.Neighbours(currentCell))
+        {
+            // the start cell may be a wall, it's only ever left:
+            if ((grid.obstacle[neighbour] && neighbour != startCell) ||
+                ctx.IsClosed(neighbour))
+                continue;
+
+            float costToMove =
+                ctx.gcost[currentCell] + grid.Distance(currentCell, neighbour);
+
+            bool inOpenList = ctx.IsOpen(neighbour);
+            if (costToMove < ctx.gcost[neighbour] || !inOpenList)
+            {
+                ctx.parent[neighbour] = currentCell;
+                ctx.gcost[neighbour] = costToMove;
+                ctx.hcost[neighbour] = grid.Distance(neighbour, side.target);
+                ctx.fcost[neighbour] = ctx.gcost[neighbour] + ctx.hcost[neighbour];
+
+                if (inOpenList)
+                    side.openList.DecreaseKey(neighbour);
+                else
+                {
+                    ctx.Open(neighbour);
+                    side.openList.Push(neighbour);
+                }
+
+                // frontiers touch:
+                if (other.IsReached(neighbour) &&
+                    costToMove + other.gcost[neighbour] < best)
+                {
+                    best = costToMove + other.gcost[neighbour];
+                    meetCell = neighbour;
+                }
+            }
+        }
+    }
+
+    if (meetCell != -1)
+    {
+        result.found = true;
+        result.cost = best;
+        result.path = RetracePath(forward.ctx, backward.ctx, meetCell);
+    }
+    return result;
+}
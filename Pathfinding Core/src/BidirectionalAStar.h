@@ -0,0 +1,21 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+/* Bidirectional A*:
+ * one frontier grown from startCell (in context) and one from endCell
+ * (in context.Backward()), always expanding the smaller open list.
+ * every time a relaxed cell has been reached by the other side, the
+ * best meeting cost is updated. the search stops once the cheapest
+ * fcost on either open list can't beat it, so path costs match
+ * AStarAlgorithm(). expanded counts both sides, expandedBackward the
+ * end side only.
+ */
+SearchResult BidirectionalAStar(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak = TieBreak::LastIn);
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/* Bit scanning helpers for 64-cell wall words.
+ * both functions expect a non-zero value.
+ */
+
+// index of the lowest set bit:
+inline int CountTrailingZeros(std::uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, static_cast<unsigned long>(value)))
+        return static_cast<int>(index);
+    _BitScanForward(&index, static_cast<unsigned long>(value >> 32));
+    return static_cast<int>(index) + 32;
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+// index of the highest set bit:
+inline int HighestBit(std::uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<int>(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanReverse(&index, static_cast<unsigned long>(value >> 32)))
+        return static_cast<int>(index) + 32;
+    _BitScanReverse(&index, static_cast<unsigned long>(value));
+    return static_cast<int>(index);
+#else
+    return 63 - __builtin_clzll(value);
+#endif
+}
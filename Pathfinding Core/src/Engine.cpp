@@ -0,0 +1,55 @@
+#include "Engine.h"
+#include "BidirectionalAStar.h"
+#include "JumpPointSearch.h"
+#include "OctileAStar.h"
+
+const char* EngineName(Engine engine)
+{
+    switch (engine)
+    {
+    case Engine::AStar:
+        return "astar";
+    case Engine::JumpPoint:
+        return "jps";
+    case Engine::Bidirectional:
+        return "bidir";
+    case Engine::Octile:
+        return "octile";
+    }
+    return "unknown";
+}
+
+bool ParseEngine(const std::string& name, Engine& engine)
+{
+    for (Engine candidate : { Engine::AStar, Engine::JumpPoint, Engine::Bidirectional, Engine::Octile })
+    {
+        if (name == EngineName(candidate))
+        {
+            engine = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+SearchResult FindPath(
+    Engine engine,
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak)
+{
+    switch (engine)
+    {
+    case Engine::JumpPoint:
+        return JumpPointSearch(grid, context, startCell, endCell, tieBreak);
+    case Engine::Bidirectional:
+        return BidirectionalAStar(grid, context, startCell, endCell, tieBreak);
+    case Engine::Octile:
+        return OctileAStar(grid, context, startCell, endCell, tieBreak);
+    case Engine::AStar:
+    default:
+        return AStarAlgorithm(grid, context, startCell, endCell, tieBreak);
+    }
+}
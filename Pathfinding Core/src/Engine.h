@@ -0,0 +1,29 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <string>
+
+// interchangeable single-query search engines:
+enum class Engine
+{
+    AStar,
+    JumpPoint,
+    Bidirectional,
+    Octile
+};
+
+// short name used on the command line ("astar", "jps", "bidir", "octile"):
+const char* EngineName(Engine engine);
+bool ParseEngine(const std::string& name, Engine& engine);
+
+// run one query with the chosen engine:
+SearchResult FindPath(
+    Engine engine,
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak = TieBreak::LastIn);
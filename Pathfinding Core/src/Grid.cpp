@@ -0,0 +1,137 @@
+#include "Grid.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace
+{
+    // versions of every grid built start in a range of their own:
+    const std::uint64_t VERSION_RANGE = std::uint64_t(1) << 32;
+    std::atomic<std::uint64_t> nextVersion{ 0 };
+}
+
+Grid::Grid(int width, int height)
+    : width(width), height(height),
+    obstacle(width * height, 0),
+    version(nextVersion.fetch_add(VERSION_RANGE, std::memory_order_relaxed)),
+    neighbourOffset{ -width, 1, width, -1, -width - 1, -width + 1, width + 1, width - 1 }
+{
+    InitBitboards();
+}
+
+void Grid::InitBitboards()
+{
+    rowWords = (width + 63) / 64;
+    columnWords = (height + 63) / 64;
+    rowBits.assign(static_cast<std::size_t>(rowWords) * height, 0);
+    columnBits.assign(static_cast<std::size_t>(columnWords) * width, 0);
+
+    // padding past the last cell of each line reads as wall:
+    auto pad = [](std::vector<std::uint64_t>& bits, int words, int lines, int length)
+    {
+        int used = length % 64;
+        if (used == 0)
+            return;
+
+        std::uint64_t padding = ~std::uint64_t(0) << used;
+        for (int line = 0; line < lines; line++)
+            bits[static_cast<std::size_t>(line) * words + words - 1] |= padding;
+    };
+    pad(rowBits, rowWords, height, width);
+    pad(columnBits, columnWords, width, height);
+
+    for (int cell = 0; cell < Size(); cell++)
+        if (obstacle[cell])
+            SetObstacle(cell, true);
+}
+
+void Grid::SetObstacle(int cell, bool blocked)
+{
+    obstacle[cell] = blocked ? 1 : 0;
+    version++;
+
+    int x = X(cell);
+    int y = Y(cell);
+    std::uint64_t& row = rowBits[static_cast<std::size_t>(y) * rowWords + x / 64];
+    std::uint64_t& column = columnBits[static_cast<std::size_t>(x) * columnWords + y / 64];
+    std::uint64_t rowMask = std::uint64_t(1) << (x % 64);
+    std::uint64_t columnMask = std::uint64_t(1) << (y % 64);
+
+    if (blocked)
+    {
+        row |= rowMask;
+        column |= columnMask;
+    }
+    else
+    {
+        row &= ~rowMask;
+        column &= ~columnMask;
+    }
+}
+
+void Grid::ClearObstacles()
+{
+    std::fill(obstacle.begin(), obstacle.end(), 0);
+    InitBitboards();
+    version++;
+}
+
+namespace
+{
+    // 64 bits of a packed line starting at bit pos, out of range reads as set:
+    std::uint64_t LineWindow(const std::uint64_t* line, int words, int pos)
+    {
+        auto word = [&](int index) -> std::uint64_t
+        {
+            return index < 0 || index >= words ? ~std::uint64_t(0) : line[index];
+        };
+
+        // floor division, pos can be negative:
+        int index = pos >= 0 ? pos / 64 : -((63 - pos) / 64);
+        int shift = pos - index * 64;
+
+        std::uint64_t bits = word(index) >> shift;
+        if (shift != 0)
+            bits |= word(index + 1) << (64 - shift);
+        return bits;
+    }
+}
+
+std::uint64_t Grid::RowWindow(int y, int x) const
+{
+    if (y < 0 || y >= height)
+        return ~std::uint64_t(0);
+    return LineWindow(&rowBits[static_cast<std::size_t>(y) * rowWords], rowWords, x);
+}
+
+std::uint64_t Grid::ColumnWindow(int x, int y) const
+{
+    if (x < 0 || x >= width)
+        return ~std::uint64_t(0);
+    return LineWindow(&columnBits[static_cast<std::size_t>(x) * columnWords], columnWords, y);
+}
+
+float Grid::Distance(int a, int b) const
+{
+    float dx = static_cast<float>(X(a) - X(b));
+    float dy = static_cast<float>(Y(a) - Y(b));
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+std::uint64_t Grid::WallHash() const
+{
+    // FNV-1a over the wall flags + size:
+    std::uint64_t hash = 14695981039346656037ull;
+    auto mix = [&hash](std::uint64_t value)
+    {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    mix(static_cast<std::uint64_t>(width));
+    mix(static_cast<std::uint64_t>(height));
+    for (std::uint8_t wall : obstacle)
+        mix(wall);
+    return hash;
+}
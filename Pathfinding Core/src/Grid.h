@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/* Compact map of walls + connections.
+ * cells are addressed by index = x + width * y and every per-cell
+ * property lives in its own contiguous array, no rendering data.
+ */
+struct Grid
+{
+    Grid(int width, int height);
+
+    int width = 0;
+    int height = 0;
+
+    // walls (1 = obstacle), write through SetObstacle() to keep the bitboards in sync:
+    std::vector<std::uint8_t> obstacle;
+
+    /* walls packed 64 cells per word, one copy row-major (bit x of row y)
+     * and one column-major (bit y of column x). padding bits past the
+     * edge are set, so scans stop at the border like at a wall.
+     */
+    int rowWords = 0;
+    int columnWords = 0;
+    std::vector<std::uint64_t> rowBits;
+    std::vector<std::uint64_t> columnBits;
+
+    /* bumped by every wall edit, tells cached results they may be stale.
+     * a grid built from scratch starts at a version no other grid has had,
+     * a copy shares it until either is edited.
+     */
+    std::uint64_t version = 0;
+
+    /* index offset of each surrounding cell, in neighbour order:
+     * top, right, bottom, left, top-left, top-right, bottom-right, bottom-left.
+     */
+    int neighbourOffset[8] = {};
+
+    // up to 8 surrounding cells, held by value (no allocation):
+    struct NeighbourList
+    {
+        int cells[8];
+        int count = 0;
+
+        const int* begin() const { return cells; }
+        const int* end() const { return cells + count; }
+    };
+
+    int Size() const { return width * height; }
+    int Index(int x, int y) const { return x + width * y; }
+    int X(int index) const { return index % width; }
+    int Y(int index) const { return index / width; }
+
+    // surrounding cells for any given cell, generated from the offset table:
+    NeighbourList Neighbours(int cell) const;
+
+    void SetObstacle(int cell, bool blocked);
+    void ClearObstacles();
+
+    /* 64 consecutive cells of row y starting at x (bit i = x + i),
+     * or of column x starting at y. cells outside the grid read as walls.
+     */
+    std::uint64_t RowWindow(int y, int x) const;
+    std::uint64_t ColumnWindow(int x, int y) const;
+
+    // straight line distance between two cells, in cells:
+    float Distance(int a, int b) const;
+
+    // hash of the wall layout, tags preprocessed data built for it:
+    std::uint64_t WallHash() const;
+
+private:
+    void InitBitboards();
+};
+
+inline Grid::NeighbourList Grid::Neighbours(int cell) const
+{
+    int y = cell / width;
+    int x = cell - y * width;
+
+    // 1 where the step stays on the grid, no branches:
+    int up = y > 0;
+    int right = x < width - 1;
+    int down = y < height - 1;
+    int left = x > 0;
+    const int inside[8] = { up, right, down, left, up & left, up & right, down & right, down & left };
+
+    // every direction is written, only cells on the grid are kept:
+    NeighbourList list;
+    for (int direction = 0; direction < 8; direction++)
+    {
+        list.cells[list.count] = cell + neighbourOffset[direction];
+        list.count += inside[direction];
+    }
+    return list;
+}
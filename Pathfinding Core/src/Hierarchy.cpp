@@ -0,0 +1,482 @@
+#include "Hierarchy.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    const float SQRT2 = 1.41421356f;
+
+    // runs of crossings at least this long get a transition at each end:
+    const int MAX_ENTRANCE_WIDTH = 6;
+
+    // link directions: right, down, down-right, down-left:
+    const int LINK_DX[] = { 1, 0, 1, -1 };
+    const int LINK_DY[] = { 0, 1, 1, 1 };
+
+    // steps to the 8 surrounding cells, straight first:
+    const int STEP_DX[] = { 0, 1, 0, -1, -1, 1, 1, -1 };
+    const int STEP_DY[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+    const float STEP_COST[] = { 1.0f, 1.0f, 1.0f, 1.0f, SQRT2, SQRT2, SQRT2, SQRT2 };
+
+    // cells of one cluster, numbered locally as x + width * y:
+    struct Bounds
+    {
+        int x0;
+        int y0;
+        int width;
+        int height;
+
+        int Local(const Grid& grid, int cell) const
+        {
+            return grid.X(cell) - x0 + width * (grid.Y(cell) - y0);
+        }
+        int Global(const Grid& grid, int local) const
+        {
+            return grid.Index(x0 + local % width, y0 + local / width);
+        }
+    };
+
+    Bounds ClusterBounds(const Grid& grid, int clusterSize, int clustersX, int cluster)
+    {
+        int x0 = cluster % clustersX * clusterSize;
+        int y0 = cluster / clustersX * clusterSize;
+        return { x0, y0,
+            std::min(clusterSize, grid.width - x0),
+            std::min(clusterSize, grid.height - y0) };
+    }
+
+    /* A* confined to bounds, state in a cluster-sized context.
+     * targetCell = -1 runs Dijkstra over the whole cluster instead.
+     * returns the number of cells expanded.
+     */
+    std::size_t LocalSearch(
+        const Grid& grid,
+        const Bounds& bounds,
+        SearchContext& local,
+        int sourceCell,
+        int targetCell)
+    {
+        std::size_t expanded = 0;
+        local.NewSearch();
+
+        int source = bounds.Local(grid, sourceCell);
+        int target = targetCell == -1 ? -1 : bounds.Local(grid, targetCell);
+        local.parent[source] = -1;
+        local.gcost[source] = 0.0f;
+        local.hcost[source] = targetCell == -1 ? 0.0f : grid.Distance(sourceCell, targetCell);
+        local.fcost[source] = local.hcost[source];
+
+        OpenList openList(local, TieBreak::LastIn);
+        local.Open(source);
+        openList.Push(source);
+
+        while (!openList.Empty())
+        {
+            int current = openList.Pop();
+            local.Close(current);
+            expanded++;
+
+            if (current == target)
+                break;
+
+            // neighbours in local coordinates, the cluster edge acts as a wall:
+            int x = current % bounds.width;
+            int y = current / bounds.width;
+            for (int step = 0; step < 8; step++)
+            {
+                int nx = x + STEP_DX[step];
+                int ny = y + STEP_DY[step];
+                if (nx < 0 || ny < 0 || nx >= bounds.width || ny >= bounds.height)
+                    continue;
+
+                int neighbour = nx + bounds.width * ny;
+                int neighbourCell = grid.Index(bounds.x0 + nx, bounds.y0 + ny);
+                if (grid.obstacle[neighbourCell] || local.IsClosed(neighbour))
+                    continue;
+
+                float costToMove = local.gcost[current] + STEP_COST[step];
+
+                bool inOpenList = local.IsOpen(neighbour);
+                if (costToMove < local.gcost[neighbour] || !inOpenList)
+                {
+                    local.parent[neighbour] = current;
+                    local.gcost[neighbour] = costToMove;
+                    local.hcost[neighbour] =
+                        targetCell == -1 ? 0.0f : grid.Distance(neighbourCell, targetCell);
+                    local.fcost[neighbour] = local.gcost[neighbour] + local.hcost[neighbour];
+
+                    if (inOpenList)
+                        openList.DecreaseKey(neighbour);
+                    else
+                    {
+                        local.Open(neighbour);
+                        openList.Push(neighbour);
+                    }
+                }
+            }
+        }
+        return expanded;
+    }
+}
+
+Hierarchy::Hierarchy(const Grid& grid, int clusterSize)
+    : grid(grid), clusterSize(clusterSize)
+{
+    Rebuild();
+}
+
+int Hierarchy::ClusterOf(int cell) const
+{
+    return grid.X(cell) / clusterSize + clustersX * (grid.Y(cell) / clusterSize);
+}
+
+int Hierarchy::Neighbour(int cluster, int direction, int sign) const
+{
+    int cx = cluster % clustersX + sign * LINK_DX[direction];
+    int cy = cluster / clustersX + sign * LINK_DY[direction];
+    if (cx < 0 || cy < 0 || cx >= clustersX || cy >= clustersY)
+        return -1;
+    return cx + clustersX * cy;
+}
+
+void Hierarchy::Rebuild()
+{
+    clustersX = (grid.width + clusterSize - 1) / clusterSize;
+    clustersY = (grid.height + clusterSize - 1) / clusterSize;
+    clusters.assign(ClusterCount(), Cluster{});
+
+    for (int cluster = 0; cluster < ClusterCount(); cluster++)
+        for (int direction = 0; direction < LINK_DIRECTIONS; direction++)
+            BuildLinks(cluster, direction);
+
+    for (int cluster = 0; cluster < ClusterCount(); cluster++)
+        BuildCluster(cluster);
+}
+
+void Hierarchy::CellChanged(int cell)
+{
+    int cluster = ClusterOf(cell);
+    std::vector<int> dirty{ cluster };
+
+    // links out of this cluster, then links into it:
+    for (int direction = 0; direction < LINK_DIRECTIONS; direction++)
+    {
+        for (int sign : { 1, -1 })
+        {
+            int other = Neighbour(cluster, direction, sign);
+            if (other == -1)
+                continue;
+
+            int from = sign > 0 ? cluster : other;
+            auto previous = clusters[from].links[direction];
+            BuildLinks(from, direction);
+
+            // other side gained or lost entrances:
+            if (clusters[from].links[direction] != previous)
+                dirty.push_back(other);
+        }
+    }
+
+    std::sort(dirty.begin(), dirty.end());
+    dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+    for (int rebuild : dirty)
+        BuildCluster(rebuild);
+}
+
+void Hierarchy::BuildLinks(int cluster, int direction)
+{
+    auto& links = clusters[cluster].links[direction];
+    links.clear();
+
+    if (Neighbour(cluster, direction, 1) == -1)
+        return;
+
+    Bounds bounds = ClusterBounds(grid, clusterSize, clustersX, cluster);
+    auto open = [&](int cell) { return !grid.obstacle[cell]; };
+
+    // corners, a single diagonal crossing:
+    if (LINK_DX[direction] != 0 && LINK_DY[direction] != 0)
+    {
+        int x = LINK_DX[direction] > 0 ? bounds.x0 + bounds.width - 1 : bounds.x0;
+        int y = bounds.y0 + bounds.height - 1;
+        int a = grid.Index(x, y);
+        int b = grid.Index(x + LINK_DX[direction], y + 1);
+        if (open(a) && open(b))
+            links.push_back({ a, b, SQRT2 });
+        return;
+    }
+
+    // straight border, cell i along it on this (side 0) or the next cluster (side 1):
+    bool vertical = direction == 0;
+    int length = vertical ? bounds.height : bounds.width;
+    auto side = [&](int i, int offset)
+    {
+        return vertical
+            ? grid.Index(bounds.x0 + bounds.width - 1 + offset, bounds.y0 + i)
+            : grid.Index(bounds.x0 + i, bounds.y0 + bounds.height - 1 + offset);
+    };
+    auto crossing = [&](int i)
+    {
+        return i >= 0 && i < length && open(side(i, 0)) && open(side(i, 1));
+    };
+
+    for (int i = 0; i < length;)
+    {
+        if (!crossing(i))
+        {
+            i++;
+            continue;
+        }
+
+        int first = i;
+        while (crossing(i))
+            i++;
+        int last = i - 1;
+
+        if (last - first + 1 < MAX_ENTRANCE_WIDTH)
+        {
+            int middle = (first + last) / 2;
+            links.push_back({ side(middle, 0), side(middle, 1), 1.0f });
+        }
+        else
+        {
+            links.push_back({ side(first, 0), side(first, 1), 1.0f });
+            links.push_back({ side(last, 0), side(last, 1), 1.0f });
+        }
+    }
+
+    /* diagonal-only crossings, neither cell next to a straight run.
+     * crossings past either end of the border belong to the corner links.
+     */
+    for (int i = 0; i < length; i++)
+    {
+        if (crossing(i) || !open(side(i, 0)))
+            continue;
+
+        for (int j : { i - 1, i + 1 })
+            if (j >= 0 && j < length && !crossing(j) && open(side(j, 1)))
+                links.push_back({ side(i, 0), side(j, 1), SQRT2 });
+    }
+}
+
+void Hierarchy::BuildCluster(int index)
+{
+    Cluster& cluster = clusters[index];
+
+    // own links start here, the neighbours' links end here:
+    cluster.entrances.clear();
+    for (int direction = 0; direction < LINK_DIRECTIONS; direction++)
+    {
+        for (const auto& link : cluster.links[direction])
+            cluster.entrances.push_back(link.a);
+
+        int other = Neighbour(index, direction, -1);
+        if (other != -1)
+            for (const auto& link : clusters[other].links[direction])
+                cluster.entrances.push_back(link.b);
+    }
+    std::sort(cluster.entrances.begin(), cluster.entrances.end());
+    cluster.entrances.erase(
+        std::unique(cluster.entrances.begin(), cluster.entrances.end()),
+        cluster.entrances.end());
+
+    // one Dijkstra per entrance finds its distance to all the others:
+    SearchContext local{ clusterSize * clusterSize };
+    Bounds bounds = ClusterBounds(grid, clusterSize, clustersX, index);
+
+    cluster.edges.assign(cluster.entrances.size(), {});
+    for (std::size_t i = 0; i < cluster.entrances.size(); i++)
+    {
+        LocalSearch(grid, bounds, local, cluster.entrances[i], -1);
+        for (int entrance : cluster.entrances)
+        {
+            int reached = bounds.Local(grid, entrance);
+            if (entrance != cluster.entrances[i] && local.IsClosed(reached))
+                cluster.edges[i].push_back({ entrance, local.gcost[reached] });
+        }
+    }
+}
+
+std::vector<Hierarchy::Edge> Hierarchy::Connect(
+    SearchContext& local,
+    int cell,
+    std::size_t& expanded) const
+{
+    int index = ClusterOf(cell);
+    Bounds bounds = ClusterBounds(grid, clusterSize, clustersX, index);
+    expanded += LocalSearch(grid, bounds, local, cell, -1);
+
+    std::vector<Edge> edges;
+    for (int entrance : clusters[index].entrances)
+    {
+        int reached = bounds.Local(grid, entrance);
+        if (entrance != cell && local.IsClosed(reached))
+            edges.push_back({ entrance, local.gcost[reached] });
+    }
+    return edges;
+}
+
+SearchResult Hierarchy::FindPath(
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak) const
+{
+    SearchResult result;
+    context.NewSearch();
+
+    if (startCell == endCell)
+    {
+        result.found = true;
+        result.path.push_back(startCell);
+        return result;
+    }
+
+    // walls are never entered, the end cell included:
+    if (grid.obstacle[endCell])
+        return result;
+
+    SearchContext local{ clusterSize * clusterSize };
+    int endCluster = ClusterOf(endCell);
+
+    // temporary nodes wired to their cluster's entrances (+ the end, if it shares the cluster):
+    std::vector<std::pair<int, std::vector<Edge>>> hooks;
+    auto hook = [&](int cell)
+    {
+        std::vector<Edge> edges = Connect(local, cell, result.expanded);
+        if (ClusterOf(cell) == endCluster)
+        {
+            // direct route inside the shared cluster, from the same search:
+            Bounds bounds = ClusterBounds(grid, clusterSize, clustersX, endCluster);
+            int reached = bounds.Local(grid, endCell);
+            if (local.IsClosed(reached))
+                edges.push_back({ endCell, local.gcost[reached] });
+        }
+        hooks.push_back({ cell, std::move(edges) });
+    };
+    hook(startCell);
+
+    // a wall start is only ever left, so no link covers its crossings into other clusters:
+    if (grid.obstacle[startCell])
+    {
+        for (int neighbour : grid.Neighbours(startCell))
+        {
+            if (grid.obstacle[neighbour] || ClusterOf(neighbour) == ClusterOf(startCell))
+                continue;
+            hooks.front().second.push_back({ neighbour, grid.Distance(startCell, neighbour) });
+            hook(neighbour);
+        }
+    }
+
+    // costs are symmetric, so entrance -> end = end -> entrance:
+    std::vector<Edge> endEdges = Connect(local, endCell, result.expanded);
+
+    auto& ctx = context;
+    ctx.parent[startCell] = -1;
+    ctx.gcost[startCell] = 0.0f;
+    ctx.hcost[startCell] = grid.Distance(startCell, endCell);
+    ctx.fcost[startCell] = ctx.hcost[startCell];
+
+    OpenList openList(ctx, tieBreak);
+    ctx.Open(startCell);
+    openList.Push(startCell);
+
+    auto relax = [&](int currentCell, int neighbour, float cost)
+    {
+        if (ctx.IsClosed(neighbour))
+            return;
+
+        float costToMove = ctx.gcost[currentCell] + cost;
+
+        bool inOpenList = ctx.IsOpen(neighbour);
+        if (costToMove < ctx.gcost[neighbour] || !inOpenList)
+        {
+            ctx.parent[neighbour] = currentCell;
+            ctx.gcost[neighbour] = costToMove;
+            ctx.hcost[neighbour] = grid.Distance(neighbour, endCell);
+            ctx.fcost[neighbour] = ctx.gcost[neighbour] + ctx.hcost[neighbour];
+
+            if (inOpenList)
+                openList.DecreaseKey(neighbour);
+            else
+            {
+                ctx.Open(neighbour);
+                openList.Push(neighbour);
+            }
+        }
+    };
+
+    while (!openList.Empty())
+    {
+        int currentCell = openList.Pop();
+        ctx.Close(currentCell);
+        result.expanded++;
+
+        if (currentCell == endCell)
+        {
+            result.found = true;
+            result.cost = ctx.gcost[endCell];
+            break;
+        }
+
+        for (const auto& hooked : hooks)
+            if (hooked.first == currentCell)
+                for (const auto& edge : hooked.second)
+                    relax(currentCell, edge.to, edge.cost);
+
+        int index = ClusterOf(currentCell);
+        if (index == endCluster)
+            for (const auto& edge : endEdges)
+                if (edge.to == currentCell)
+                    relax(currentCell, endCell, edge.cost);
+
+        // transition cell: in-cluster edges + links to the neighbouring clusters:
+        const Cluster& cluster = clusters[index];
+        auto slot = std::lower_bound(cluster.entrances.begin(), cluster.entrances.end(), currentCell);
+        if (slot == cluster.entrances.end() || *slot != currentCell)
+            continue;
+
+        for (const auto& edge : cluster.edges[slot - cluster.entrances.begin()])
+            relax(currentCell, edge.to, edge.cost);
+
+        for (int direction = 0; direction < LINK_DIRECTIONS; direction++)
+        {
+            for (const auto& link : cluster.links[direction])
+                if (link.a == currentCell)
+                    relax(currentCell, link.b, link.cost);
+
+            int other = Neighbour(index, direction, -1);
+            if (other != -1)
+                for (const auto& link : clusters[other].links[direction])
+                    if (link.b == currentCell)
+                        relax(currentCell, link.a, link.cost);
+        }
+    }
+
+    if (!result.found)
+        return result;
+
+    // refine: hops inside a cluster are searched again locally, links are single steps:
+    std::vector<int> hops = RetracePath(ctx, endCell);
+    result.path.push_back(hops.front());
+    for (std::size_t i = 1; i < hops.size(); i++)
+    {
+        int from = hops[i - 1];
+        int to = hops[i];
+        if (ClusterOf(from) != ClusterOf(to))
+        {
+            result.path.push_back(to);
+            continue;
+        }
+
+        Bounds bounds = ClusterBounds(grid, clusterSize, clustersX, ClusterOf(from));
+        result.expanded += LocalSearch(grid, bounds, local, from, to);
+
+        std::size_t hopStart = result.path.size();
+        for (int tracker = bounds.Local(grid, to); tracker != bounds.Local(grid, from); tracker = local.parent[tracker])
+            result.path.push_back(bounds.Global(grid, tracker));
+        std::reverse(result.path.begin() + hopStart, result.path.end());
+    }
+    return result;
+}
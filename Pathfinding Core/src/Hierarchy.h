@@ -0,0 +1,88 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <cstddef>
+#include <vector>
+
+/* Hierarchical pathfinding (HPA*):
+ * the grid is split into clusterSize x clusterSize clusters. walkable
+ * runs along each shared border become transitions (one in the middle
+ * of a short run, one at each end of a long one), and every pair of
+ * transition cells inside a cluster is joined by its exact in-cluster
+ * distance. queries search that abstract graph, then refine each hop
+ * with A* confined to one cluster. paths are near-optimal, not exact.
+ *
+ * keeps a reference to grid, call CellChanged() after each wall edit
+ * (only the clusters whose transitions or walls changed are rebuilt)
+ * or Rebuild() after bulk edits.
+ */
+class Hierarchy
+{
+public:
+    // a fair balance of search speed and path quality, shared by every front end:
+    static constexpr int DEFAULT_CLUSTER_SIZE = 16;
+
+    explicit Hierarchy(const Grid& grid, int clusterSize = DEFAULT_CLUSTER_SIZE);
+
+    void Rebuild();
+    void CellChanged(int cell);
+
+    /* abstract search state is written into context (sized to grid),
+     * reached cells are transition cells + the start/end.
+     */
+    SearchResult FindPath(
+        SearchContext& context,
+        int startCell,
+        int endCell,
+        TieBreak tieBreak = TieBreak::LastIn) const;
+
+    int ClusterSize() const { return clusterSize; }
+    int ClusterCount() const { return clustersX * clustersY; }
+    int ClusterOf(int cell) const;
+
+private:
+    struct Edge
+    {
+        int to;         // cell
+        float cost;
+    };
+
+    // crossing from a cell of one cluster to an adjacent cell of the next:
+    struct Transition
+    {
+        int a;
+        int b;
+        float cost;
+
+        bool operator==(const Transition& other) const { return a == other.a && b == other.b; }
+    };
+
+    // links to the cluster right, below, below-right and below-left:
+    static const int LINK_DIRECTIONS = 4;
+
+    struct Cluster
+    {
+        std::vector<Transition> links[LINK_DIRECTIONS]; // a in this cluster
+        std::vector<int> entrances;                     // every transition cell inside the cluster
+        std::vector<std::vector<Edge>> edges;           // in-cluster edges, per entrance
+    };
+
+    // cluster next to cluster in a link direction, -1 = off the grid:
+    int Neighbour(int cluster, int direction, int sign) const;
+
+    void BuildLinks(int cluster, int direction);
+    void BuildCluster(int cluster);
+
+    // in-cluster distances from cell to its cluster's entrances:
+    std::vector<Edge> Connect(SearchContext& local, int cell, std::size_t& expanded) const;
+
+    const Grid& grid;
+    int clusterSize;
+    int clustersX = 0;
+    int clustersY = 0;
+
+    std::vector<Cluster> clusters;
+};
@@ -0,0 +1,158 @@
+#include "IncrementalPlanner.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+    const float INF = std::numeric_limits<float>::infinity();
+}
+
+IncrementalPlanner::IncrementalPlanner(const Grid& grid)
+    : grid(grid),
+    context(grid.Size()),
+    openList(context, TieBreak::LastIn),
+    rhs(grid.Size(), INF)
+{
+}
+
+// cells the current tree never reached read as unreachable:
+float IncrementalPlanner::G(int cell) const
+{
+    return context.IsReached(cell) ? context.gcost[cell] : INF;
+}
+
+float IncrementalPlanner::Rhs(int cell) const
+{
+    return context.IsReached(cell) ? rhs[cell] : INF;
+}
+
+void IncrementalPlanner::Reset(int startCell, int endCell)
+{
+    // empty the queue, stamps alone would leave its heap slots behind:
+    while (!openList.Empty())
+        openList.Pop();
+
+    context.NewSearch();
+    this->startCell = startCell;
+    this->endCell = endCell;
+
+    if (startCell < 0 || endCell < 0)
+        return;
+
+    Touch(startCell);
+    rhs[startCell] = 0.0f;
+    UpdateCell(startCell);
+}
+
+void IncrementalPlanner::CellChanged(int cell)
+{
+    // steps into cell changed cost, steps out of it didn't:
+    if (startCell >= 0 && endCell >= 0)
+        UpdateCell(cell);
+}
+
+void IncrementalPlanner::Touch(int cell)
+{
+    if (context.IsReached(cell))
+        return;
+
+    context.gcost[cell] = INF;
+    context.parent[cell] = -1;
+    rhs[cell] = INF;
+    context.Close(cell);
+}
+
+void IncrementalPlanner::UpdateCell(int cell)
+{
+    Touch(cell);
+
+    // walls are never entered, the start is only ever left:
+    if (cell != startCell)
+    {
+        rhs[cell] = INF;
+        context.parent[cell] = -1;
+        if (!grid.obstacle[cell])
+        {
+            for (int neighbour : grid.Neighbours(cell))
+            {
+                float cost = G(neighbour) + grid.Distance(neighbour, cell);
+                if (cost < rhs[cell])
+                {
+                    rhs[cell] = cost;
+                    context.parent[cell] = neighbour;
+                }
+            }
+        }
+    }
+
+    if (context.IsOpen(cell))
+    {
+        openList.Remove(cell);
+        context.Close(cell);
+    }
+
+    // inconsistent, (re)queue under its new key:
+    if (context.gcost[cell] != rhs[cell])
+    {
+        float best = std::min(context.gcost[cell], rhs[cell]);
+        context.hcost[cell] = best;
+        context.fcost[cell] = best + grid.Distance(cell, endCell);
+        context.Open(cell);
+        openList.Push(cell);
+    }
+}
+
+SearchResult IncrementalPlanner::ComputePath()
+{
+    SearchResult result;
+    if (startCell < 0 || endCell < 0)
+        return result;
+
+    /* cell's key sorts before the end cell's, h(end) = 0.
+     * g + h along a straight line can round just past the end's g,
+     * so first keys that close count as equal and fall to the second key.
+     */
+    auto beforeEnd = [&](int cell)
+    {
+        float best = std::min(G(endCell), Rhs(endCell));
+        if (best == INF)
+            return true;
+
+        float slack = best * 1e-5f + 1e-4f;
+        if (context.fcost[cell] < best - slack)
+            return true;
+        return context.fcost[cell] <= best + slack && context.hcost[cell] < best;
+    };
+
+    while (!openList.Empty() &&
+        (beforeEnd(openList.Top()) || Rhs(endCell) != G(endCell)))
+    {
+        int cell = openList.Pop();
+        context.Close(cell);
+        result.expanded++;
+
+        if (context.gcost[cell] > rhs[cell])
+        {
+            // overconsistent, settle it:
+            context.gcost[cell] = rhs[cell];
+        }
+        else
+        {
+            // underconsistent, forget it and look again:
+            context.gcost[cell] = INF;
+            UpdateCell(cell);
+        }
+
+        for (int neighbour : grid.Neighbours(cell))
+            UpdateCell(neighbour);
+    }
+
+    if (G(endCell) != INF)
+    {
+        result.found = true;
+        result.cost = G(endCell);
+        result.path = RetracePath(context, endCell);
+    }
+    return result;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <vector>
+
+/* Lifelong Planning A* (LPA*):
+ * keeps its search tree between queries for a fixed start + end cell.
+ * after a wall edit only the edited cell is marked inconsistent, and
+ * ComputePath() repairs just the part of the tree that depends on it,
+ * instead of replanning from scratch. path costs match AStarAlgorithm().
+ *
+ * keeps a reference to grid, call CellChanged() after each wall edit.
+ */
+class IncrementalPlanner
+{
+public:
+    explicit IncrementalPlanner(const Grid& grid);
+
+    // new endpoints (-1 = none), forgets the tree:
+    void Reset(int startCell, int endCell);
+    void CellChanged(int cell);
+
+    // repair the tree, expanded = cells taken off the queue by this call:
+    SearchResult ComputePath();
+
+    int StartCell() const { return startCell; }
+    int EndCell() const { return endCell; }
+
+    /* reached cells carry g in gcost, inconsistent ones are open.
+     * fcost + hcost hold the two-part queue key [min(g, rhs) + h, min(g, rhs)].
+     */
+    const SearchContext& Context() const { return context; }
+
+private:
+    float G(int cell) const;
+    float Rhs(int cell) const;
+
+    void Touch(int cell);
+    void UpdateCell(int cell);
+
+    const Grid& grid;
+    SearchContext context;
+    OpenList openList;
+
+    // one step lookahead of g, best neighbour g + step cost:
+    std::vector<float> rhs;
+
+    int startCell = -1;
+    int endCell = -1;
+};
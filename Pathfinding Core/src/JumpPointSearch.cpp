@@ -0,0 +1,307 @@
+#include "JumpPointSearch.h"
+#include "Bitboard.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace
+{
+    const float SQRT2 = 1.41421356f;
+
+    int Sign(int value)
+    {
+        return (value > 0) - (value < 0);
+    }
+
+    class Jumper
+    {
+    public:
+        Jumper(const Grid& grid, int endCell)
+            : grid(grid), endX(grid.X(endCell)), endY(grid.Y(endCell))
+        {
+        }
+
+        bool Walkable(int x, int y) const
+        {
+            return x >= 0 && y >= 0 && x < grid.width && y < grid.height &&
+                !grid.obstacle[grid.Index(x, y)];
+        }
+
+        /* walk from (x, y) in direction (dx, dy) until a jump point,
+         * the end cell or a wall. returns the jump point cell or -1.
+         */
+        int Jump(int x, int y, int dx, int dy) const
+        {
+            if (dx == 0 || dy == 0)
+                return JumpStraight(x, y, dx, dy);
+
+            // diagonal, one cell at a time:
+            while (true)
+            {
+                x += dx;
+                y += dy;
+
+                if (!Walkable(x, y))
+                    return -1;
+                if (x == endX && y == endY)
+                    return grid.Index(x, y);
+
+                // forced neighbours around a diagonal step:
+                if ((!Walkable(x - dx, y) && Walkable(x - dx, y + dy)) ||
+                    (!Walkable(x, y - dy) && Walkable(x + dx, y - dy)))
+                    return grid.Index(x, y);
+
+                // diagonal cell is a jump point if a straight jump from it finds one:
+                if (JumpStraight(x, y, dx, 0) != -1 || JumpStraight(x, y, 0, dy) != -1)
+                    return grid.Index(x, y);
+            }
+        }
+
+        /* straight jump along a row (dy = 0) or column (dx = 0), 64 cells
+         * per step: walls and forced neighbours for a whole word are found
+         * with a few shifts + masks over the bitboards, then a bit scan.
+         */
+        int JumpStraight(int x, int y, int dx, int dy) const
+        {
+            const bool horizontal = dx != 0;
+            const int dir = horizontal ? dx : dy;
+            const int line = horizontal ? y : x;
+            const int pos = horizontal ? x : y;
+            const bool endOnLine = horizontal ? endY == y : endX == x;
+            const int endPos = horizontal ? endX : endY;
+
+            auto window = [&](int l, int p)
+            {
+                return horizontal ? grid.RowWindow(l, p) : grid.ColumnWindow(l, p);
+            };
+            auto cell = [&](int p)
+            {
+                return horizontal ? grid.Index(p, y) : grid.Index(x, p);
+            };
+
+            if (dir > 0)
+            {
+                // bit i = cell first + i:
+                for (int first = pos + 1; ; first += 64)
+                {
+                    std::uint64_t walls = window(line, first);
+                    std::uint64_t side = window(line - 1, first);
+                    std::uint64_t sideAhead = window(line - 1, first + 1);
+                    std::uint64_t other = window(line + 1, first);
+                    std::uint64_t otherAhead = window(line + 1, first + 1);
+
+                    // blocked beside this cell, open beside the next:
+                    std::uint64_t forced = (side & ~sideAhead) | (other & ~otherAhead);
+                    std::uint64_t stops = walls | forced;
+                    int stop = stops ? CountTrailingZeros(stops) : 64;
+
+                    if (endOnLine && endPos >= first && endPos - first < stop)
+                        return cell(endPos);
+                    if (stops == 0)
+                        continue;
+
+                    return (walls >> stop) & 1 ? -1 : cell(first + stop);
+                }
+            }
+
+            // bit i = cell last - 63 + i, scanning downwards:
+            for (int last = pos - 1; ; last -= 64)
+            {
+                int first = last - 63;
+                std::uint64_t walls = window(line, first);
+                std::uint64_t side = window(line - 1, first);
+                std::uint64_t sideAhead = window(line - 1, first - 1);
+                std::uint64_t other = window(line + 1, first);
+                std::uint64_t otherAhead = window(line + 1, first - 1);
+
+                std::uint64_t forced = (side & ~sideAhead) | (other & ~otherAhead);
+                std::uint64_t stops = walls | forced;
+                int stop = stops ? HighestBit(stops) : -1;
+
+                if (endOnLine && endPos <= last && endPos - first > stop)
+                    return cell(endPos);
+                if (stops == 0)
+                    continue;
+
+                return (walls >> stop) & 1 ? -1 : cell(first + stop);
+            }
+        }
+
+        /* directions worth jumping in from (x, y) when arriving along (dx, dy).
+         * (0, 0) = start cell, every direction is searched.
+         * returns the number of directions written to out.
+         */
+        int PrunedDirections(int x, int y, int dx, int dy, int (*out)[2]) const
+        {
+            int count = 0;
+            auto add = [&](int ddx, int ddy)
+            {
+                if (Walkable(x + ddx, y + ddy))
+                {
+                    out[count][0] = ddx;
+                    out[count][1] = ddy;
+                    count++;
+                }
+            };
+
+            if (dx == 0 && dy == 0)
+            {
+                for (int ddy = -1; ddy <= 1; ddy++)
+                    for (int ddx = -1; ddx <= 1; ddx++)
+                        if (ddx != 0 || ddy != 0)
+                            add(ddx, ddy);
+            }
+            else if (dx != 0 && dy != 0)
+            {
+                // natural:
+                add(dx, 0);
+                add(0, dy);
+                add(dx, dy);
+
+                // forced:
+                if (!Walkable(x - dx, y))
+                    add(-dx, dy);
+                if (!Walkable(x, y - dy))
+                    add(dx, -dy);
+            }
+            else if (dx != 0)
+            {
+                add(dx, 0);
+                if (!Walkable(x, y + 1))
+                    add(dx, 1);
+                if (!Walkable(x, y - 1))
+                    add(dx, -1);
+            }
+            else
+            {
+                add(0, dy);
+                if (!Walkable(x + 1, y))
+                    add(1, dy);
+                if (!Walkable(x - 1, y))
+                    add(-1, dy);
+            }
+            return count;
+        }
+
+        // octile distance, exact cost of a straight/diagonal jump:
+        float JumpCost(int a, int b) const
+        {
+            int dx = std::abs(grid.X(a) - grid.X(b));
+            int dy = std::abs(grid.Y(a) - grid.Y(b));
+            int diagonal = std::min(dx, dy);
+            int straight = std::max(dx, dy) - diagonal;
+            return diagonal * SQRT2 + straight;
+        }
+
+    private:
+        const Grid& grid;
+        int endX;
+        int endY;
+    };
+
+    // fill in the cells between consecutive jump points:
+    std::vector<int> ExpandPath(const Grid& grid, const std::vector<int>& jumpPoints)
+    {
+        std::vector<int> path;
+        if (jumpPoints.empty())
+            return path;
+
+        path.push_back(jumpPoints.front());
+        for (std::size_t i = 1; i < jumpPoints.size(); i++)
+        {
+            int x = grid.X(jumpPoints[i - 1]);
+            int y = grid.Y(jumpPoints[i - 1]);
+            int tx = grid.X(jumpPoints[i]);
+            int ty = grid.Y(jumpPoints[i]);
+            while (x != tx || y != ty)
+            {
+                x += Sign(tx - x);
+                y += Sign(ty - y);
+                path.push_back(grid.Index(x, y));
+            }
+        }
+        return path;
+    }
+}
+
+SearchResult JumpPointSearch(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak)
+{
+    SearchResult result;
+    Jumper jumper(grid, endCell);
+
+    context.NewSearch();
+
+    auto& ctx = context;
+    ctx.parent[startCell] = -1;
+    ctx.gcost[startCell] = 0.0f;
+    ctx.hcost[startCell] = grid.Distance(startCell, endCell);
+    ctx.fcost[startCell] = ctx.hcost[startCell];
+
+    OpenList openList(ctx, tieBreak);
+    ctx.Open(startCell);
+    openList.Push(startCell);
+
+    int directions[8][2];
+    while (!openList.Empty())
+    {
+        int currentCell = openList.Pop();
+        ctx.Close(currentCell);
+        result.expanded++;
+
+        if (currentCell == endCell)
+        {
+            result.found = true;
+            result.cost = ctx.gcost[endCell];
+            result.path = ExpandPath(grid, RetracePath(ctx, endCell));
+            return result;
+        }
+
+        int x = grid.X(currentCell);
+        int y = grid.Y(currentCell);
+
+        // direction we arrived from:
+        int dx = 0;
+        int dy = 0;
+        if (ctx.parent[currentCell] != -1)
+        {
+            dx = Sign(x - grid.X(ctx.parent[currentCell]));
+            dy = Sign(y - grid.Y(ctx.parent[currentCell]));
+        }
+
+        int count = jumper.PrunedDirections(x, y, dx, dy, directions);
+        for (int i = 0; i < count; i++)
+        {
+            int jumpPoint = jumper.Jump(x, y, directions[i][0], directions[i][1]);
+            if (jumpPoint == -1 || ctx.IsClosed(jumpPoint))
+                continue;
+
+            float costToMove =
+                ctx.gcost[currentCell] + jumper.JumpCost(currentCell, jumpPoint);
+
+            bool inOpenList = ctx.IsOpen(jumpPoint);
+            if (costToMove < ctx.gcost[jumpPoint] || !inOpenList)
+            {
+                ctx.parent[jumpPoint] = currentCell;
+                ctx.gcost[jumpPoint] = costToMove;
+                ctx.hcost[jumpPoint] = grid.Distance(jumpPoint, endCell);
+                ctx.fcost[jumpPoint] = ctx.gcost[jumpPoint] + ctx.hcost[jumpPoint];
+
+                if (inOpenList)
+                    openList.DecreaseKey(jumpPoint);
+                else
+                {
+                    ctx.Open(jumpPoint);
+                    openList.Push(jumpPoint);
+                }
+            }
+        }
+    }
+
+    return result;
+}
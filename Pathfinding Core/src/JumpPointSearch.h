@@ -0,0 +1,19 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+/* Jump Point Search:
+ * A* over the same uniform-cost 8-connected grid, but instead of
+ * pushing every neighbour it jumps along straight + diagonal lines
+ * and only stops at cells with forced neighbours (jump points).
+ * path costs match AStarAlgorithm(), far fewer cells are expanded.
+ * the returned path is expanded back to every cell between jump points.
+ */
+SearchResult JumpPointSearch(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak = TieBreak::LastIn);
@@ -0,0 +1,190 @@
+#include "Landmarks.h"
+#include "AStar.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <limits>
+
+namespace
+{
+    const char FILE_MAGIC[4] = { 'A', 'L', 'T', '1' };
+    const float UNREACHABLE = std::numeric_limits<float>::infinity();
+}
+
+Landmarks::Landmarks(const Grid& grid)
+    : grid(grid)
+{
+}
+
+std::vector<int> Landmarks::PlaceLandmarks(int count) const
+{
+    std::vector<int> placed;
+    std::vector<bool> taken(grid.Size(), false);
+    int perimeter = 2 * (grid.width + grid.height);
+
+    for (int i = 0; i < count; i++)
+    {
+        // evenly spaced point walking clockwise around the border:
+        int along = static_cast<int>(static_cast<long long>(i) * perimeter / count);
+        int x, y;
+        if (along < grid.width)
+            x = along, y = 0;
+        else if ((along -= grid.width) < grid.height)
+            x = grid.width - 1, y = along;
+        else if ((along -= grid.height) < grid.width)
+            x = grid.width - 1 - along, y = grid.height - 1;
+        else
+            x = 0, y = grid.height - 1 - (along - grid.width);
+
+        // nearest open cell not already taken:
+        int best = -1;
+        long long bestDistance = 0;
+        for (int cell = 0; cell < grid.Size(); cell++)
+        {
+            if (grid.obstacle[cell] || taken[cell])
+                continue;
+
+            long long dx = grid.X(cell) - x;
+            long long dy = grid.Y(cell) - y;
+            long long distance = dx * dx + dy * dy;
+            if (best == -1 || distance < bestDistance)
+            {
+                best = cell;
+                bestDistance = distance;
+            }
+        }
+
+        // fewer open cells than landmarks:
+        if (best == -1)
+            break;
+        placed.push_back(best);
+        taken[best] = true;
+    }
+    return placed;
+}
+
+void Landmarks::Distances(SearchContext& context, int landmark)
+{
+    Dijkstra(grid, context, cells[landmark]);
+
+    // this landmark's column of the table:
+    std::size_t count = cells.size();
+    for (int c = 0; c < grid.Size(); c++)
+        distances[c * count + landmark] = context.IsClosed(c) ? context.gcost[c] : UNREACHABLE;
+}
+
+void Landmarks::Build(int count, unsigned threadCount)
+{
+    cells = PlaceLandmarks(count);
+    distances.assign(static_cast<std::size_t>(grid.Size()) * cells.size(), UNREACHABLE);
+
+    // hardware_concurrency() may not know, no point in idle threads:
+    threadCount = std::max(threadCount, 1u);
+    threadCount = std::min(threadCount, static_cast<unsigned>(std::max<std::size_t>(cells.size(), 1)));
+
+    // every thread takes the next landmark until none are left:
+    std::atomic<int> next{ 0 };
+    auto worker = [&]()
+    {
+        SearchContext context{ grid.Size() };
+        for (int landmark = next++; landmark < Count(); landmark = next++)
+            Distances(context, landmark);
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++)
+        threads.emplace_back(worker);
+    worker();
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+float Landmarks::Heuristic(int cell, int endCell) const
+{
+    float bound = grid.Distance(cell, endCell);
+
+    std::size_t count = cells.size();
+    const float* from = &distances[cell * count];
+    const float* to = &distances[endCell * count];
+    for (std::size_t i = 0; i < count; i++)
+    {
+        // landmark in neither cell's region, says nothing:
+        if (from[i] == UNREACHABLE && to[i] == UNREACHABLE)
+            continue;
+
+        // infinite if only one of them reaches it, no path then:
+        bound = std::max(bound, std::fabs(from[i] - to[i]));
+    }
+    return bound;
+}
+
+bool Landmarks::Save(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::int32_t header[3] = { grid.width, grid.height, Count() };
+    std::uint64_t hash = grid.WallHash();
+
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    file.write(reinterpret_cast<const char*>(cells.data()), cells.size() * sizeof(int));
+    file.write(reinterpret_cast<const char*>(distances.data()), distances.size() * sizeof(float));
+    return static_cast<bool>(file);
+}
+
+bool Landmarks::Load(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        return false;
+
+    char magic[4] = {};
+    std::int32_t header[3] = {};
+    std::uint64_t hash = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+
+    // different map, or same map with different walls:
+    if (!file ||
+        !std::equal(magic, magic + 4, FILE_MAGIC) ||
+        header[0] != grid.width || header[1] != grid.height ||
+        header[2] < 0 || header[2] > grid.Size() ||
+        hash != grid.WallHash())
+        return false;
+
+    // the tables have to be all there before anything is allocated for them:
+    std::streamoff tables = static_cast<std::streamoff>(header[2]) * sizeof(int) +
+        static_cast<std::streamoff>(grid.Size()) * header[2] * sizeof(float);
+    std::streamoff at = file.tellg();
+    file.seekg(0, std::ios::end);
+    if (!file || file.tellg() - at != tables)
+        return false;
+    file.seekg(at);
+
+    std::vector<int> loadedCells(header[2]);
+    std::vector<float> loadedDistances(static_cast<std::size_t>(grid.Size()) * header[2]);
+    file.read(reinterpret_cast<char*>(loadedCells.data()), loadedCells.size() * sizeof(int));
+    file.read(reinterpret_cast<char*>(loadedDistances.data()), loadedDistances.size() * sizeof(float));
+    if (!file)
+        return false;
+
+    // landmarks are distinct open cells, anything else isn't a table of ours:
+    std::vector<bool> taken(grid.Size(), false);
+    for (int cell : loadedCells)
+    {
+        if (cell < 0 || cell >= grid.Size() || grid.obstacle[cell] || taken[cell])
+            return false;
+        taken[cell] = true;
+    }
+
+    cells = std::move(loadedCells);
+    distances = std::move(loadedDistances);
+    return true;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* ALT (A*, landmarks, triangle inequality) heuristic tables.
+ * exact distances from a few landmark cells to every cell, then for
+ * any two cells |d(L, a) - d(L, b)| <= d(a, b). the largest bound over
+ * all landmarks (never less than the straight line distance) is an
+ * admissible heuristic that sees around walls, which Euclidean can't.
+ *
+ * landmarks are spread evenly around the grid border, snapped to the
+ * nearest open cell. tables are only valid for the walls they were
+ * built on, rebuild or reload after edits.
+ */
+class Landmarks
+{
+public:
+    explicit Landmarks(const Grid& grid);
+
+    // one Dijkstra per landmark, spread over threadCount threads:
+    void Build(int count, unsigned threadCount = std::thread::hardware_concurrency());
+
+    /* binary tables, tagged with the grid size + a hash of its walls.
+     * Load() returns false if the file can't be read, was built for
+     * different walls or names landmarks that aren't open cells of the
+     * grid, the current tables are kept then.
+     */
+    bool Save(const std::string& filename) const;
+    bool Load(const std::string& filename);
+
+    // lower bound on the path cost between two cells:
+    float Heuristic(int cell, int endCell) const;
+
+    int Count() const { return static_cast<int>(cells.size()); }
+    const std::vector<int>& Cells() const { return cells; }
+
+private:
+    std::vector<int> PlaceLandmarks(int count) const;
+    void Distances(SearchContext& context, int landmark);
+
+    const Grid& grid;
+    std::vector<int> cells;         // landmark cells
+    std::vector<float> distances;   // [cell * count + landmark], infinity = unreachable
+};
@@ -0,0 +1,85 @@
+#include "MapFile.h"
+
+#include <fstream>
+#include <utility>
+
+namespace
+{
+    bool IsPassable(char tile)
+    {
+        return tile == '.' || tile == 'G' || tile == 'S';
+    }
+}
+
+bool LoadMap(const std::string& filename, Grid& grid)
+{
+    std::ifstream file(filename);
+    if (!file)
+        return false;
+
+    // header:
+    int width = 0;
+    int height = 0;
+    std::string key;
+    while (file >> key && key != "map")
+    {
+        if (key == "height")
+            file >> height;
+        else if (key == "width")
+            file >> width;
+        else
+            file >> key;    // type <name>
+    }
+
+    if (key != "map" || width <= 0 || height <= 0)
+        return false;
+
+    Grid loaded(width, height);
+
+    // tiles, one row per line:
+    std::string row;
+    for (int y = 0; y < height; y++)
+    {
+        if (!(file >> row) || static_cast<int>(row.size()) < width)
+            return false;
+
+        for (int x = 0; x < width; x++)
+            loaded.SetObstacle(loaded.Index(x, y), !IsPassable(row[x]));
+    }
+
+    grid = std::move(loaded);
+    return true;
+}
+
+bool LoadScenarios(const std::string& filename, std::vector<Scenario>& scenarios)
+{
+    std::ifstream file(filename);
+    if (!file)
+        return false;
+
+    // header:
+    std::string key;
+    double version = 0.0;
+    if (!(file >> key >> version) || key != "version")
+        return false;
+
+    std::vector<Scenario> loaded;
+    Scenario scenario;
+    while (file >> scenario.bucket)
+    {
+        if (!(file >> scenario.map
+            >> scenario.mapWidth >> scenario.mapHeight
+            >> scenario.startX >> scenario.startY
+            >> scenario.endX >> scenario.endY
+            >> scenario.optimalLength))
+            return false;
+        loaded.push_back(scenario);
+    }
+
+    // stopped on something other than a bucket number:
+    if (!file.eof())
+        return false;
+
+    scenarios = std::move(loaded);
+    return true;
+}
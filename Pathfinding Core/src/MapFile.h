@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Grid.h"
+
+#include <string>
+#include <vector>
+
+/* Moving AI benchmark map format:
+ *   type octile
+ *   height <h>
+ *   width <w>
+ *   map
+ *   <h rows of w characters>
+ * '.', 'G' and 'S' are passable, everything else is a wall.
+ * returns false if the file can't be read or is malformed.
+ */
+bool LoadMap(const std::string& filename, Grid& grid);
+
+// one query of a Moving AI scenario:
+struct Scenario
+{
+    int bucket = 0;
+    std::string map;
+    int mapWidth = 0;
+    int mapHeight = 0;
+    int startX = 0;
+    int startY = 0;
+    int endX = 0;
+    int endY = 0;
+    double optimalLength = 0.0;     // octile, without cutting corners
+};
+
+/* Moving AI scenario format:
+ *   version 1
+ *   <bucket> <map> <width> <height> <startX> <startY> <endX> <endY> <optimal length>
+ * one query per line. returns false if the file can't be read or a
+ * line is malformed.
+ */
+bool LoadScenarios(const std::string& filename, std::vector<Scenario>& scenarios);
@@ -0,0 +1,164 @@
+#include "OctileAStar.h"
+#include "Bitboard.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+    const std::uint32_t STRAIGHT_COST = 70;
+    const std::uint32_t DIAGONAL_COST = 99;
+
+    /* Monotone priority queue over 32 bit keys:
+     * bucket 0 holds keys equal to the last popped one, bucket i keys
+     * whose highest bit differing from it is bit i - 1. popping from an
+     * empty bucket 0 redistributes the lowest non-empty bucket around
+     * its minimum, each entry only ever moves to lower buckets.
+     */
+    class RadixHeap
+    {
+    public:
+        struct Entry
+        {
+            std::uint32_t key;
+            int cell;
+        };
+
+        explicit RadixHeap(TieBreak policy) : policy(policy) {}
+
+        bool Empty() const { return size == 0; }
+
+        // key must not be below the last popped key:
+        void Push(std::uint32_t key, int cell)
+        {
+            buckets[BucketOf(key)].push_back({ key, cell });
+            size++;
+        }
+
+        Entry Pop()
+        {
+            if (head == buckets[0].size())
+                Refill();
+
+            size--;
+            auto& equal = buckets[0];
+            if (policy == TieBreak::FirstIn)
+                return equal[head++];
+
+            Entry entry = equal.back();
+            equal.pop_back();
+            return entry;
+        }
+
+    private:
+        int BucketOf(std::uint32_t key) const
+        {
+            return key == last ? 0 : HighestBit(key ^ last) + 1;
+        }
+
+        void Refill()
+        {
+            buckets[0].clear();
+            head = 0;
+
+            int index = 1;
+            while (buckets[index].empty())
+                index++;
+
+            auto& bucket = buckets[index];
+            last = std::min_element(bucket.begin(), bucket.end(),
+                [](const Entry& a, const Entry& b) { return a.key < b.key; })->key;
+
+            for (const Entry& entry : bucket)
+                buckets[BucketOf(entry.key)].push_back(entry);
+            bucket.clear();
+        }
+
+        std::vector<Entry> buckets[33];
+        std::uint32_t last = 0;
+        std::size_t size = 0;
+        std::size_t head = 0;   // next of bucket 0, first-in only
+        TieBreak policy;
+    };
+}
+
+SearchResult OctileAStar(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak)
+{
+    SearchResult result;
+
+    // forget previous search in O(1):
+    context.NewSearch();
+    auto& ctx = context;
+
+    // octile distance to the end cell, from indices only:
+    int endX = grid.X(endCell);
+    int endY = grid.Y(endCell);
+    auto distance = [&](int cell)
+    {
+        std::uint32_t dx = static_cast<std::uint32_t>(std::abs(cell % grid.width - endX));
+        std::uint32_t dy = static_cast<std::uint32_t>(std::abs(cell / grid.width - endY));
+        return STRAIGHT_COST * std::max(dx, dy) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dx, dy);
+    };
+
+    ctx.parent[startCell] = -1;
+    ctx.gscore[startCell] = 0;
+
+    // cells to test, cheapest on top:
+    RadixHeap openList(tieBreak);
+    ctx.Open(startCell);
+    openList.Push(distance(startCell), startCell);
+
+    while (!openList.Empty())
+    {
+        // no decrease-key, a cell whose cost dropped since its push is skipped:
+        RadixHeap::Entry top = openList.Pop();
+        int currentCell = top.cell;
+        if (ctx.IsClosed(currentCell) ||
+            top.key != ctx.gscore[currentCell] + distance(currentCell))
+            continue;
+
+        ctx.Close(currentCell);
+        result.expanded++;
+
+        // end goal reached:
+        if (currentCell == endCell)
+        {
+            result.found = true;
+            result.path = RetracePath(ctx, endCell);
+            result.cost = PathCost(grid, result.path);
+            return result;
+        }
+
+        for (int neighbour : grid.Neighbours(currentCell))
+        {
+            if (grid.obstacle[neighbour] ||
+                ctx.IsClosed(neighbour))
+                continue;
+
+            // straight neighbours are width cells away, or 1 along the same row:
+            int offset = std::abs(neighbour - currentCell);
+            bool straight = offset == grid.width ||
+                (offset == 1 && neighbour / grid.width == currentCell / grid.width);
+            std::uint32_t costToMove = ctx.gscore[currentCell] +
+                (straight ? STRAIGHT_COST : DIAGONAL_COST);
+
+            if (!ctx.IsOpen(neighbour) || costToMove < ctx.gscore[neighbour])
+            {
+                ctx.parent[neighbour] = currentCell;
+                ctx.gscore[neighbour] = costToMove;
+                ctx.Open(neighbour);
+                openList.Push(costToMove + distance(neighbour), neighbour);
+            }
+        }
+    }
+
+    // open list exhausted, no path:
+    return result;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+/* A* on integer costs:
+ * straight steps cost 70 and diagonal steps 99 (99 / 70 is within
+ * 0.005% of sqrt 2), so every path cost is an exact integer and
+ * comparisons never depend on float rounding. the heuristic is octile
+ * distance on the same scale, worked out from cell indices alone.
+ *
+ * with a consistent integer heuristic, fcost never drops below the
+ * last one popped, so the open list is a radix heap: buckets by the
+ * highest bit that differs from the last popped key, O(1) push and
+ * amortised O(log C) pop, no decrease-key (stale entries are skipped).
+ * tieBreak picks the order among cells with the same fcost.
+ *
+ * costs are kept in SearchContext::gscore, path costs up to about
+ * 43 million diagonal steps fit. the returned cost is the float path
+ * cost, same units as AStarAlgorithm(), and within rounding of it.
+ */
+SearchResult OctileAStar(
+    const Grid& grid,
+    SearchContext& context,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak = TieBreak::LastIn);
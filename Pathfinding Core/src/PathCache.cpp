@@ -0,0 +1,134 @@
+#include "PathCache.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+PathCache::PathCache(const Grid& grid, std::size_t capacity)
+    : grid(grid), capacity(std::max<std::size_t>(capacity, 1))
+{
+}
+
+bool PathCache::Key::operator==(const Key& other) const
+{
+    return startCell == other.startCell && endCell == other.endCell && variant == other.variant;
+}
+
+std::size_t PathCache::KeyHash::operator()(const Key& key) const
+{
+    std::uint64_t cells = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.startCell)) << 32) |
+        static_cast<std::uint32_t>(key.endCell);
+    return std::hash<std::uint64_t>()(cells ^ (key.variant * 0x9e3779b97f4a7c15ull));
+}
+
+const SearchResult* PathCache::Find(int startCell, int endCell, std::uint32_t variant)
+{
+    auto it = lookup.find(Key{ startCell, endCell, variant });
+    if (it == lookup.end())
+    {
+        misses++;
+        return nullptr;
+    }
+
+    // found before an edit nobody reported:
+    if (it->second->version != grid.version)
+    {
+        entries.erase(it->second);
+        lookup.erase(it);
+        invalidations++;
+        misses++;
+        return nullptr;
+    }
+
+    // move to the front, most recently used:
+    entries.splice(entries.begin(), entries, it->second);
+    hits++;
+    return &entries.front().result;
+}
+
+const SearchResult& PathCache::Insert(int startCell, int endCell, SearchResult result, std::uint32_t variant)
+{
+    Key key{ startCell, endCell, variant };
+
+    auto it = lookup.find(key);
+    if (it != lookup.end())
+    {
+        entries.erase(it->second);
+        lookup.erase(it);
+    }
+    else if (entries.size() >= capacity)
+    {
+        lookup.erase(entries.back().key);
+        entries.pop_back();
+        evictions++;
+    }
+
+    Entry entry;
+    entry.key = key;
+    entry.version = grid.version;
+    entry.minX = std::min(grid.X(startCell), grid.X(endCell));
+    entry.minY = std::min(grid.Y(startCell), grid.Y(endCell));
+    entry.maxX = std::max(grid.X(startCell), grid.X(endCell));
+    entry.maxY = std::max(grid.Y(startCell), grid.Y(endCell));
+    for (int cell : result.path)
+    {
+        entry.minX = std::min(entry.minX, grid.X(cell));
+        entry.minY = std::min(entry.minY, grid.Y(cell));
+        entry.maxX = std::max(entry.maxX, grid.X(cell));
+        entry.maxY = std::max(entry.maxY, grid.Y(cell));
+    }
+    entry.result = std::move(result);
+
+    entries.push_front(std::move(entry));
+    lookup[key] = entries.begin();
+    return entries.front().result;
+}
+
+bool PathCache::Affects(const Entry& entry, int cell, bool blocked) const
+{
+    int x = grid.X(cell);
+    int y = grid.Y(cell);
+
+    if (blocked)
+    {
+        // no path stays no path, a path only breaks if the wall lands on it:
+        return entry.result.found &&
+            x >= entry.minX && x <= entry.maxX &&
+            y >= entry.minY && y <= entry.maxY;
+    }
+
+    // an opened cell can connect anything, or shorten a path it's close enough to:
+    if (!entry.result.found)
+        return true;
+
+    float detour = grid.Distance(entry.key.startCell, cell) + grid.Distance(cell, entry.key.endCell);
+    return detour < entry.result.cost + 1e-3f;
+}
+
+void PathCache::CellChanged(int cell)
+{
+    bool blocked = grid.obstacle[cell] != 0;
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        // only entries current right before this edit can be carried over:
+        bool current = it->version + 1 == grid.version;
+        if (current && !Affects(*it, cell, blocked))
+        {
+            it->version = grid.version;
+            ++it;
+            continue;
+        }
+
+        lookup.erase(it->key);
+        it = entries.erase(it);
+        invalidations++;
+    }
+}
+
+void PathCache::Clear()
+{
+    invalidations += entries.size();
+    entries.clear();
+    lookup.clear();
+}
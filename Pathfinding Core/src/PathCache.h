@@ -0,0 +1,81 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+/* Bounded LRU cache of search results, keyed by start, end and a
+ * variant (whatever else the caller's results depend on, e.g. engine
+ * + tie-break, 0 if nothing), stamped with the grid version they were
+ * found at. a result is only returned while the grid version still
+ * matches.
+ *
+ * call CellChanged() after each wall edit: entries the edit can't
+ * affect are carried over to the new version, the rest are dropped.
+ * a new wall only matters inside a path's bounding box, a removed wall
+ * only if a detour through it could beat the cached cost.
+ * edits it doesn't hear about (or bulk ones) simply turn every entry
+ * into a miss.
+ */
+class PathCache
+{
+public:
+    explicit PathCache(const Grid& grid, std::size_t capacity = 256);
+
+    // cached result at the current grid version, nullptr on a miss:
+    const SearchResult* Find(int startCell, int endCell, std::uint32_t variant = 0);
+
+    // stores result as found at the current grid version, evicting the least recently used:
+    const SearchResult& Insert(int startCell, int endCell, SearchResult result, std::uint32_t variant = 0);
+
+    void CellChanged(int cell);
+    void Clear();
+
+    std::size_t Size() const { return entries.size(); }
+    std::size_t Capacity() const { return capacity; }
+
+    std::size_t Hits() const { return hits; }
+    std::size_t Misses() const { return misses; }
+    std::size_t Evictions() const { return evictions; }
+    std::size_t Invalidations() const { return invalidations; }
+
+private:
+    struct Key
+    {
+        int startCell;
+        int endCell;
+        std::uint32_t variant;
+
+        bool operator==(const Key& other) const;
+    };
+
+    struct KeyHash
+    {
+        std::size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        Key key;
+        std::uint64_t version;
+        int minX, minY, maxX, maxY;     // bounding box of the path
+        SearchResult result;
+    };
+
+    bool Affects(const Entry& entry, int cell, bool blocked) const;
+
+    const Grid& grid;
+    std::size_t capacity;
+
+    std::list<Entry> entries;       // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup;
+
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+    std::size_t evictions = 0;
+    std::size_t invalidations = 0;
+};
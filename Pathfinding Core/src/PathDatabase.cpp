@@ -0,0 +1,302 @@
+#include "PathDatabase.h"
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <utility>
+
+namespace
+{
+    const char FILE_MAGIC[4] = { 'C', 'P', 'D', '1' };
+
+    // same order as Grid::Neighbours(): top, right, bottom, left, top-left, top-right, bottom-right, bottom-left
+    const int STEP_X[] = { 0, 1, 0, -1, -1, 1, 1, -1 };
+    const int STEP_Y[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+
+    const std::uint8_t NO_STEP = 8;     // target can't be reached
+    const std::uint8_t ANY_STEP = 9;    // wall or the source itself, fits any run
+
+    // positions are packed above a 4 bit step:
+    const int MAX_CELLS = 1 << 28;
+
+    int StepBetween(const Grid& grid, int from, int to)
+    {
+        int dx = grid.X(to) - grid.X(from);
+        int dy = grid.Y(to) - grid.Y(from);
+        for (int step = 0; step < 8; step++)
+            if (STEP_X[step] == dx && STEP_Y[step] == dy)
+                return step;
+        return NO_STEP;
+    }
+
+    // interleaved x + y bits:
+    std::uint64_t Morton(std::uint32_t x, std::uint32_t y)
+    {
+        auto spread = [](std::uint64_t v)
+        {
+            v = (v | (v << 16)) & 0x0000ffff0000ffffull;
+            v = (v | (v << 8)) & 0x00ff00ff00ff00ffull;
+            v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0full;
+            v = (v | (v << 2)) & 0x3333333333333333ull;
+            v = (v | (v << 1)) & 0x5555555555555555ull;
+            return v;
+        };
+        return spread(x) | (spread(y) << 1);
+    }
+}
+
+PathDatabase::PathDatabase(const Grid& grid)
+    : grid(grid)
+{
+}
+
+void PathDatabase::InitOrder()
+{
+    cellAt.resize(grid.Size());
+    for (int cell = 0; cell < grid.Size(); cell++)
+        cellAt[cell] = cell;
+
+    std::sort(cellAt.begin(), cellAt.end(), [&](int a, int b)
+        {
+            return Morton(grid.X(a), grid.Y(a)) < Morton(grid.X(b), grid.Y(b));
+        });
+
+    order.resize(grid.Size());
+    for (int position = 0; position < grid.Size(); position++)
+        order[cellAt[position]] = position;
+}
+
+void PathDatabase::BuildRow(
+    SearchContext& context,
+    int sourceCell,
+    std::vector<std::uint8_t>& steps,
+    std::vector<int>& chain,
+    std::vector<std::uint32_t>& row) const
+{
+    Dijkstra(grid, context, sourceCell);
+
+    // first step to each cell, inherited down the shortest path tree:
+    std::fill(steps.begin(), steps.end(), NO_STEP);
+    steps[sourceCell] = ANY_STEP;
+    for (int cell = 0; cell < grid.Size(); cell++)
+    {
+        if (grid.obstacle[cell])
+            steps[cell] = ANY_STEP;
+        if (steps[cell] != NO_STEP || !context.IsClosed(cell))
+            continue;
+
+        // climb to a cell whose step is known, or to a child of the source:
+        chain.clear();
+        int tracker = cell;
+        while (steps[tracker] == NO_STEP && context.parent[tracker] != sourceCell)
+        {
+            chain.push_back(tracker);
+            tracker = context.parent[tracker];
+        }
+
+        std::uint8_t step = steps[tracker] != NO_STEP
+            ? steps[tracker]
+            : static_cast<std::uint8_t>(StepBetween(grid, sourceCell, tracker));
+        steps[tracker] = step;
+        for (int c : chain)
+            steps[c] = step;
+    }
+
+    // run-length along the curve, don't-care targets extend the current run:
+    row.clear();
+    std::uint8_t current = ANY_STEP;
+    for (int position = 0; position < grid.Size(); position++)
+    {
+        std::uint8_t step = steps[cellAt[position]];
+        if (step == ANY_STEP || step == current)
+            continue;
+
+        // first run always starts at 0, covering don't-cares before it:
+        std::uint32_t start = row.empty() ? 0 : static_cast<std::uint32_t>(position);
+        row.push_back((start << 4) | step);
+        current = step;
+    }
+
+    // nothing but don't-cares:
+    if (row.empty())
+        row.push_back(NO_STEP);
+}
+
+void PathDatabase::Build(unsigned threadCount)
+{
+    InitOrder();
+    rowStart.clear();
+    runs.clear();
+    if (grid.Size() == 0 || grid.Size() > MAX_CELLS)
+        return;
+
+    std::vector<std::vector<std::uint32_t>> rows(grid.Size());
+
+    // hardware_concurrency() may not know:
+    threadCount = std::max(threadCount, 1u);
+
+    // every thread takes the next source cell until none are left:
+    std::atomic<int> next{ 0 };
+    auto worker = [&]()
+    {
+        SearchContext context{ grid.Size() };
+        std::vector<std::uint8_t> steps(grid.Size());
+        std::vector<int> chain;
+        for (int source = next++; source < grid.Size(); source = next++)
+            BuildRow(context, source, steps, chain, rows[source]);
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < threadCount; i++)
+        threads.emplace_back(worker);
+    worker();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    // rows back to back:
+    rowStart.reserve(rows.size() + 1);
+    for (auto& row : rows)
+    {
+        rowStart.push_back(runs.size());
+        runs.insert(runs.end(), row.begin(), row.end());
+        std::vector<std::uint32_t>().swap(row);
+    }
+    rowStart.push_back(runs.size());
+}
+
+int PathDatabase::NextCell(int cell, int endCell) const
+{
+    if (runs.empty() || cell == endCell)
+        return -1;
+
+    // last run starting at or before the target's position:
+    std::uint32_t key = (static_cast<std::uint32_t>(order[endCell]) << 4) | 0xf;
+    const std::uint32_t* first = runs.data() + rowStart[cell];
+    const std::uint32_t* last = runs.data() + rowStart[cell + 1];
+    const std::uint32_t* run = std::upper_bound(first, last, key) - 1;
+
+    int step = *run & 0xf;
+    if (step >= 8)
+        return -1;
+    return grid.Index(grid.X(cell) + STEP_X[step], grid.Y(cell) + STEP_Y[step]);
+}
+
+SearchResult PathDatabase::FindPath(int startCell, int endCell) const
+{
+    SearchResult result;
+
+    // start is also the end, same as A*:
+    if (startCell == endCell)
+    {
+        result.found = true;
+        result.path.push_back(startCell);
+        return result;
+    }
+
+    // walls are don't-cares, the table can't answer for them:
+    if (runs.empty() || grid.obstacle[endCell])
+        return result;
+
+    // every step gets strictly closer, a path can't revisit a cell:
+    result.path.push_back(startCell);
+    for (int cell = startCell; cell != endCell;)
+    {
+        cell = NextCell(cell, endCell);
+        if (cell == -1 || static_cast<int>(result.path.size()) > grid.Size())
+        {
+            result.path.clear();
+            return result;
+        }
+        result.path.push_back(cell);
+    }
+
+    result.found = true;
+    result.cost = PathCost(grid, result.path);
+    return result;
+}
+
+bool PathDatabase::Save(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        return false;
+
+    std::int32_t header[2] = { grid.width, grid.height };
+    std::uint64_t hash = grid.WallHash();
+    std::uint64_t runCount = runs.size();
+
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&hash), sizeof(hash));
+    file.write(reinterpret_cast<const char*>(&runCount), sizeof(runCount));
+    file.write(reinterpret_cast<const char*>(rowStart.data()), rowStart.size() * sizeof(std::uint64_t));
+    file.write(reinterpret_cast<const char*>(runs.data()), runs.size() * sizeof(std::uint32_t));
+    return static_cast<bool>(file);
+}
+
+bool PathDatabase::Load(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        return false;
+
+    char magic[4] = {};
+    std::int32_t header[2] = {};
+    std::uint64_t hash = 0;
+    std::uint64_t runCount = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(header), sizeof(header));
+    file.read(reinterpret_cast<char*>(&hash), sizeof(hash));
+    file.read(reinterpret_cast<char*>(&runCount), sizeof(runCount));
+
+    // different map, or same map with different walls:
+    if (!file ||
+        !std::equal(magic, magic + 4, FILE_MAGIC) ||
+        header[0] != grid.width || header[1] != grid.height ||
+        hash != grid.WallHash())
+        return false;
+
+    // the tables have to be all there before anything is allocated for them:
+    std::uint64_t startBytes = (static_cast<std::uint64_t>(grid.Size()) + 1) * sizeof(std::uint64_t);
+    std::streamoff at = file.tellg();
+    file.seekg(0, std::ios::end);
+    std::uint64_t left = static_cast<std::uint64_t>(file.tellg() - at);
+    if (!file || left < startBytes || (left - startBytes) / sizeof(std::uint32_t) != runCount ||
+        (left - startBytes) % sizeof(std::uint32_t) != 0)
+        return false;
+    file.seekg(at);
+
+    std::vector<std::uint64_t> loadedStart(static_cast<std::size_t>(grid.Size()) + 1);
+    std::vector<std::uint32_t> loadedRuns(runCount);
+    file.read(reinterpret_cast<char*>(loadedStart.data()), loadedStart.size() * sizeof(std::uint64_t));
+    file.read(reinterpret_cast<char*>(loadedRuns.data()), loadedRuns.size() * sizeof(std::uint32_t));
+    if (!file || loadedStart.front() != 0 || loadedStart.back() != runCount)
+        return false;
+
+    // as Build() writes them: every row has runs, the first from position 0, and no step leaves the grid
+    for (int cell = 0; cell < grid.Size(); cell++)
+    {
+        if (loadedStart[cell] >= loadedStart[cell + 1] || loadedRuns[loadedStart[cell]] >> 4 != 0)
+            return false;
+
+        for (std::uint64_t i = loadedStart[cell]; i < loadedStart[cell + 1]; i++)
+        {
+            int step = loadedRuns[i] & 0xf;
+            if (step == NO_STEP)
+                continue;
+            if (step > NO_STEP)
+                return false;
+
+            int x = grid.X(cell) + STEP_X[step];
+            int y = grid.Y(cell) + STEP_Y[step];
+            if (x < 0 || x >= grid.width || y < 0 || y >= grid.height)
+                return false;
+        }
+    }
+
+    rowStart = std::move(loadedStart);
+    runs = std::move(loadedRuns);
+    InitOrder();
+    return true;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+/* Compressed path database (CPD):
+ * for every cell, the first step of an optimal path to every other
+ * cell. targets are laid out along a Z-order curve, so nearby targets
+ * share a first step, and each source's row is stored as runs of
+ * (position, step). walls are "don't care" targets and never break a
+ * run. a path is then read one step at a time, each step a binary
+ * search in one row, without any search over the grid.
+ *
+ * steps use the same 8 directions, in the same order, as
+ * Grid::Neighbours(). building costs one Dijkstra per cell, so it's
+ * meant to run offline and be loaded from disk. only valid for the
+ * walls it was built on.
+ */
+class PathDatabase
+{
+public:
+    explicit PathDatabase(const Grid& grid);
+
+    // one Dijkstra per source cell, spread over threadCount threads:
+    void Build(unsigned threadCount = std::thread::hardware_concurrency());
+
+    /* binary runs, tagged with a hash of the grid's walls + size.
+     * Load() returns false if the file can't be read or was built
+     * for different walls, the current database is kept then.
+     */
+    bool Save(const std::string& filename) const;
+    bool Load(const std::string& filename);
+
+    // next cell of an optimal path from cell towards endCell, -1 if there's no path:
+    int NextCell(int cell, int endCell) const;
+
+    // follows NextCell() from start to end, expanded stays 0:
+    SearchResult FindPath(int startCell, int endCell) const;
+
+    bool Empty() const { return runs.empty(); }
+    std::size_t RunCount() const { return runs.size(); }
+
+private:
+    void InitOrder();
+    void BuildRow(SearchContext& context, int sourceCell, std::vector<std::uint8_t>& steps,
+        std::vector<int>& chain, std::vector<std::uint32_t>& row) const;
+
+    const Grid& grid;
+    std::vector<int> order;             // position of each cell along the Z-order curve
+    std::vector<int> cellAt;            // cell at each position
+    std::vector<std::uint64_t> rowStart;    // first run of each source cell, + total
+    std::vector<std::uint32_t> runs;        // (first position << 4) | step
+};
@@ -0,0 +1,94 @@
+#include "QueryPool.h"
+
+#include <algorithm>
+
+QueryPool::QueryPool(const Grid& grid, unsigned threadCount)
+    : grid(grid)
+{
+    // hardware_concurrency() may not know:
+    threadCount = std::max(threadCount, 1u);
+
+    contexts.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++)
+        contexts.emplace_back(grid.Size());
+
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; i++)
+        workers.emplace_back(&QueryPool::WorkerLoop, this, i);
+}
+
+QueryPool::~QueryPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+std::vector<SearchResult> QueryPool::Solve(
+    Engine engine,
+    const Query* queries,
+    std::size_t count,
+    TieBreak tieBreak)
+{
+    const Grid& shared = grid;
+    return Solve(
+        [&shared, engine, tieBreak](SearchContext& context, int startCell, int endCell)
+        {
+            return FindPath(engine, shared, context, startCell, endCell, tieBreak);
+        },
+        queries, count);
+}
+
+std::vector<SearchResult> QueryPool::Solve(
+    const SearchFunction& search,
+    const Query* queries,
+    std::size_t count)
+{
+    std::vector<SearchResult> results(count);
+    if (count == 0)
+        return results;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    this->search = &search;
+    this->queries = queries;
+    this->count = count;
+    this->results = &results;
+    next = 0;
+    busy = ThreadCount();
+    batch++;
+    wake.notify_all();
+
+    done.wait(lock, [this] { return busy == 0; });
+    this->results = nullptr;
+    return results;
+}
+
+void QueryPool::WorkerLoop(unsigned index)
+{
+    SearchContext& context = contexts[index];
+    unsigned seen = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || batch != seen; });
+            if (stopping)
+                return;
+            seen = batch;
+        }
+
+        // batch fields don't change until every worker has checked out:
+        for (std::size_t i = next++; i < count; i = next++)
+            (*results)[i] = (*search)(context, queries[i].startCell, queries[i].endCell);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--busy == 0)
+            done.notify_one();
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "AStar.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// one start -> end pair of a batch:
+struct Query
+{
+    int startCell;
+    int endCell;
+};
+
+/* Worker threads solving batches of queries over one shared grid.
+ * each worker owns a search context, queries are handed out one at a
+ * time so long and short queries balance across workers.
+ * grid is only read, it must not change while Solve() runs.
+ * one batch at a time, Solve() isn't meant to be called concurrently.
+ */
+class QueryPool
+{
+public:
+    // search run by a worker, with its own context:
+    using SearchFunction = std::function<SearchResult(SearchContext&, int startCell, int endCell)>;
+
+    explicit QueryPool(const Grid& grid, unsigned threadCount = std::thread::hardware_concurrency());
+    ~QueryPool();
+
+    QueryPool(const QueryPool&) = delete;
+    QueryPool& operator=(const QueryPool&) = delete;
+
+    // results[i] answers queries[i], blocks until the whole batch is done:
+    std::vector<SearchResult> Solve(
+        Engine engine,
+        const Query* queries,
+        std::size_t count,
+        TieBreak tieBreak = TieBreak::LastIn);
+
+    std::vector<SearchResult> Solve(
+        const SearchFunction& search,
+        const Query* queries,
+        std::size_t count);
+
+    unsigned ThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+private:
+    void WorkerLoop(unsigned index);
+
+    const Grid& grid;
+    std::vector<SearchContext> contexts;    // one per worker
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    unsigned batch = 0;         // bumped for every Solve()
+    unsigned busy = 0;          // workers still on the current batch
+    bool stopping = false;
+
+    // current batch, valid while busy > 0:
+    const SearchFunction* search = nullptr;
+    const Query* queries = nullptr;
+    std::size_t count = 0;
+    std::vector<SearchResult>* results = nullptr;
+    std::atomic<std::size_t> next{ 0 };
+};
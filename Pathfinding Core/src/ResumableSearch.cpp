@@ -0,0 +1,86 @@
+#include "ResumableSearch.h"
+
+namespace
+{
+    // reading the clock every expansion would cost more than small steps:
+    const std::size_t CLOCK_INTERVAL = 32;
+}
+
+ResumableSearch::ResumableSearch(const Grid& grid, SearchContext& context)
+    : grid(grid), context(context)
+{
+}
+
+void ResumableSearch::Start(int startCell, int endCell, TieBreak tieBreak)
+{
+    // forget previous search in O(1):
+    context.NewSearch();
+    result = SearchResult();
+    this->endCell = endCell;
+    currentCell = -1;
+    running = true;
+
+    auto& ctx = context;
+    ctx.parent[startCell] = -1;
+    ctx.gcost[startCell] = 0.0f;
+    ctx.hcost[startCell] = grid.Distance(startCell, endCell);
+    ctx.fcost[startCell] = ctx.hcost[startCell];
+
+    // cells to test, cheapest on top:
+    openList.emplace(ctx, tieBreak);
+    ctx.Open(startCell);
+    openList->Push(startCell);
+}
+
+void ResumableSearch::Cancel()
+{
+    running = false;
+    openList.reset();
+}
+
+bool ResumableSearch::Step(std::size_t maxExpansions, std::chrono::microseconds timeBudget)
+{
+    if (!running)
+        return true;
+
+    // only a time budget needs the clock, an expansion count never reads it:
+    bool timed = timeBudget.count() > 0;
+    std::chrono::steady_clock::time_point deadline;
+    if (timed)
+        deadline = std::chrono::steady_clock::now() + timeBudget;
+    auto& ctx = context;
+
+    for (std::size_t expanded = 0; maxExpansions == 0 || expanded < maxExpansions; expanded++)
+    {
+        // open list exhausted, no path:
+        if (openList->Empty())
+        {
+            Cancel();
+            return true;
+        }
+
+        // out of time, carry on next step:
+        if (timed && expanded > 0 && expanded % CLOCK_INTERVAL == 0 &&
+            std::chrono::steady_clock::now() >= deadline)
+            return false;
+
+        // same expansion as AStarAlgorithm(), neighbours relaxed unless it's the end:
+        currentCell = ExpandNext(grid, ctx, *openList, endCell, EuclideanHeuristic{ grid });
+        result.expanded++;
+        if (expandedCells)
+            expandedCells->push_back(currentCell);
+
+        // end goal reached:
+        if (currentCell == endCell)
+        {
+            result.found = true;
+            result.cost = ctx.gcost[endCell];
+            result.path = RetracePath(ctx, endCell);
+            Cancel();
+            return true;
+        }
+    }
+
+    // expansion budget used up:
+    return false;
+}
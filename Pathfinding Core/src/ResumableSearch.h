@@ -0,0 +1,57 @@
+#pragma once
+
+#include "AStar.h"
+#include "Grid.h"
+#include "SearchContext.h"
+
+#include <chrono>
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+/* A* that can stop after any expansion and carry on later:
+ * Start() sets up the query, each Step() expands cells until it runs
+ * out of its expansion or time budget (or the search ends), so a big
+ * search can be spread over many frames. same expansion order and
+ * path as AStarAlgorithm().
+ *
+ * search state lives in context (read it between steps to draw the
+ * frontier). grid must not change while a search is running, Cancel()
+ * it instead.
+ */
+class ResumableSearch
+{
+public:
+    ResumableSearch(const Grid& grid, SearchContext& context);
+
+    void Start(int startCell, int endCell, TieBreak tieBreak = TieBreak::LastIn);
+    void Cancel();
+
+    /* expands up to maxExpansions cells (0 = no limit), stopping early
+     * once timeBudget has passed (0 = no limit). returns true once the
+     * search has finished, Result() is final then.
+     */
+    bool Step(std::size_t maxExpansions, std::chrono::microseconds timeBudget = std::chrono::microseconds(0));
+
+    bool Running() const { return running; }
+
+    // cells expanded by later steps are appended to cells in order, nullptr = not recorded:
+    void RecordExpanded(std::vector<int>* cells) { expandedCells = cells; }
+
+    // last cell expanded, -1 before the first step:
+    int CurrentCell() const { return currentCell; }
+
+    // expanded counts every step so far:
+    const SearchResult& Result() const { return result; }
+
+private:
+    const Grid& grid;
+    SearchContext& context;
+    std::optional<OpenList> openList;
+
+    int endCell = -1;
+    int currentCell = -1;
+    bool running = false;
+    SearchResult result;
+    std::vector<int>* expandedCells = nullptr;
+};
@@ -0,0 +1,153 @@
+#include "SearchContext.h"
+
+#include <algorithm>
+
+SearchContext::SearchContext(int cellCount)
+{
+    Resize(cellCount);
+}
+
+void SearchContext::Resize(int cellCount)
+{
+    generation = 2;
+    visited.assign(cellCount, 0);
+
+    // nothing is copied or initialised, every cell reads as unreached:
+    auto reset = [cellCount](auto& field)
+    {
+        field.clear();
+        field.resize(cellCount);
+    };
+    reset(gcost);
+    reset(hcost);
+    reset(fcost);
+    reset(parent);
+    reset(heapIndex);
+    reset(gscore);
+
+    if (backward)
+        backward->Resize(cellCount);
+}
+
+void SearchContext::NewSearch()
+{
+    generation += 2;
+
+    // stamps wrapped around, old stamps could alias the new generation:
+    if (generation == 0)
+    {
+        std::fill(visited.begin(), visited.end(), 0);
+        generation = 2;
+    }
+
+    if (backward)
+        backward->NewSearch();
+}
+
+SearchContext& SearchContext::Backward()
+{
+    if (!backward)
+        backward = std::make_unique<SearchContext>(static_cast<int>(visited.size()));
+    return *backward;
+}
+
+OpenList::OpenList(SearchContext& context, TieBreak policy)
+    : context(context), policy(policy)
+{
+}
+
+void OpenList::Push(int cell)
+{
+    context.heapIndex[cell] = static_cast<int>(heap.size());
+    heap.push_back({ cell, counter++ });
+    SiftUp(context.heapIndex[cell]);
+}
+
+int OpenList::Pop()
+{
+    int top = heap.front().cell;
+    Swap(0, static_cast<int>(heap.size()) - 1);
+    heap.pop_back();
+    context.heapIndex[top] = -1;
+
+    if (!heap.empty())
+        SiftDown(0);
+    return top;
+}
+
+void OpenList::DecreaseKey(int cell)
+{
+    SiftUp(context.heapIndex[cell]);
+}
+
+void OpenList::Update(int cell)
+{
+    SiftUp(context.heapIndex[cell]);
+    SiftDown(context.heapIndex[cell]);
+}
+
+void OpenList::Remove(int cell)
+{
+    int slot = context.heapIndex[cell];
+    int last = static_cast<int>(heap.size()) - 1;
+    Swap(slot, last);
+    heap.pop_back();
+    context.heapIndex[cell] = -1;
+
+    // the cell moved into the hole can belong either side of it:
+    if (slot != last)
+        Update(heap[slot].cell);
+}
+
+bool OpenList::Less(const Entry& a, const Entry& b) const
+{
+    if (context.fcost[a.cell] != context.fcost[b.cell])
+        return context.fcost[a.cell] < context.fcost[b.cell];
+    if (context.hcost[a.cell] != context.hcost[b.cell])
+        return context.hcost[a.cell] < context.hcost[b.cell];
+
+    // deterministic tie-break on insertion order:
+    return policy == TieBreak::FirstIn
+        ? a.order < b.order
+        : a.order > b.order;
+}
+
+void OpenList::Swap(int i, int j)
+{
+    std::swap(heap[i], heap[j]);
+    context.heapIndex[heap[i].cell] = i;
+    context.heapIndex[heap[j].cell] = j;
+}
+
+void OpenList::SiftUp(int i)
+{
+    while (i > 0)
+    {
+        int parent = (i - 1) / 2;
+        if (!Less(heap[i], heap[parent]))
+            break;
+        Swap(i, parent);
+        i = parent;
+    }
+}
+
+void OpenList::SiftDown(int i)
+{
+    const int size = static_cast<int>(heap.size());
+    while (true)
+    {
+        int smallest = i;
+        int left = 2 * i + 1;
+        int right = left + 1;
+
+        if (left < size && Less(heap[left], heap[smallest]))
+            smallest = left;
+        if (right < size && Less(heap[right], heap[smallest]))
+            smallest = right;
+        if (smallest == i)
+            break;
+
+        Swap(i, smallest);
+        i = smallest;
+    }
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// order in which cells with equal fcost + hcost leave the open list:
+enum class TieBreak
+{
+    FirstIn,    // oldest cell first
+    LastIn      // newest cell first
+};
+
+/* Allocator that leaves new elements uninitialised. per-cell costs are
+ * always written before a stamp lets anything read them, so growing a
+ * context doesn't sweep them, and the pages of cells no search reaches
+ * are never touched (a 10k x 10k context only costs what it searches).
+ */
+template <typename T>
+struct UninitialisedAllocator : std::allocator<T>
+{
+    template <typename U>
+    struct rebind { using other = UninitialisedAllocator<U>; };
+
+    UninitialisedAllocator() = default;
+    template <typename U>
+    UninitialisedAllocator(const UninitialisedAllocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* p) noexcept { ::new (static_cast<void*>(p)) U; }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) { ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+};
+
+template <typename T>
+using CellArray = std::vector<T, UninitialisedAllocator<T>>;
+
+/* Per-cell search state, one contiguous array per field.
+ * a cell reached by the current search is stamped with its generation
+ * (open) or generation + 1 (closed), anything else reads as untouched,
+ * so a new search starts by bumping the generation instead of sweeping
+ * every cell.
+ */
+struct SearchContext
+{
+    explicit SearchContext(int cellCount = 0);
+
+    void Resize(int cellCount);
+
+    // also forgets the backward side, if there is one:
+    void NewSearch();
+
+    // state for a frontier grown from the end cell, created on first use:
+    SearchContext& Backward();
+
+    bool IsOpen(int cell) const { return visited[cell] == generation; }
+    bool IsClosed(int cell) const { return visited[cell] == generation + 1; }
+    bool IsReached(int cell) const { return IsOpen(cell) || IsClosed(cell); }
+
+    void Open(int cell) { visited[cell] = generation; }
+    void Close(int cell) { visited[cell] = generation + 1; }
+
+    // stamps 0 + 1 mean never reached:
+    unsigned int generation = 2;
+
+    // the only field read before it's written, zeroed on Resize():
+    std::vector<unsigned int> visited;
+
+    // only meaningful for cells reached by the current search:
+    CellArray<float> gcost;      // distance from start cell
+    CellArray<float> hcost;      // distance from end cell (heuristic)
+    CellArray<float> fcost;      // g + h = fcost
+    CellArray<int> parent;       // -1 = no parent
+    CellArray<int> heapIndex;    // slot in the open list
+    CellArray<std::uint32_t> gscore;    // integer distance from start cell (OctileAStar only)
+
+private:
+    std::unique_ptr<SearchContext> backward;
+};
+
+/* Indexed binary min-heap of cells keyed on (fcost, hcost).
+ * every cell's heap slot is kept in the search context, so push, pop
+ * and decrease-key are all O(log n) instead of O(n) scans.
+ */
+class OpenList
+{
+public:
+    OpenList(SearchContext& context, TieBreak policy);
+
+    bool Empty() const { return heap.empty(); }
+    std::size_t Size() const { return heap.size(); }
+
+    // cheapest cell, without removing it:
+    int Top() const { return heap.front().cell; }
+
+    void Push(int cell);
+    int Pop();
+
+    // restore heap order after a cell's cost was lowered:
+    void DecreaseKey(int cell);
+
+    // same, after a cell's cost changed either way:
+    void Update(int cell);
+
+    // take a cell out from anywhere in the heap:
+    void Remove(int cell);
+
+private:
+    struct Entry
+    {
+        int cell;
+        unsigned int order;
+    };
+
+    bool Less(const Entry& a, const Entry& b) const;
+    void Swap(int i, int j);
+    void SiftUp(int i);
+    void SiftDown(int i);
+
+    SearchContext& context;
+    std::vector<Entry> heap;
+    TieBreak policy;
+    unsigned int counter = 0;
+};
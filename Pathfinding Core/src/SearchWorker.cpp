@@ -0,0 +1,246 @@
+#include "SearchWorker.h"
+#include "Hierarchy.h"
+#include "ResumableSearch.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+    // polled about 60 times a second, room for that long's worth of expansions:
+    const std::size_t QUEUE_CAPACITY = 1 << 16;
+
+    // expansions between checks for a newer ticket, each batch is sent as far as the queue has room:
+    const std::size_t CHECK_INTERVAL = 256;
+
+    // edits held for the next request, past this many it sends a full copy instead:
+    const std::size_t MAX_CHANGED_CELLS = 1 << 20;
+
+    // idle worker polls for requests this often, backing off to about once per GUI tick while none come:
+    const std::chrono::microseconds IDLE_SLEEP(500);
+    const std::chrono::microseconds MAX_IDLE_SLEEP(16000);
+}
+
+SearchWorker::SearchWorker()
+    : updates(QUEUE_CAPACITY)
+{
+    worker = std::thread(&SearchWorker::WorkerLoop, this);
+}
+
+SearchWorker::~SearchWorker()
+{
+    stopping = true;
+    worker.join();
+
+    delete pending.exchange(nullptr);
+}
+
+std::unique_ptr<SearchWorker::Request> SearchWorker::TakeBack()
+{
+    std::unique_ptr<Request> request(pending.exchange(nullptr, std::memory_order_acq_rel));
+    if (!request)
+        request = std::move(unsent);
+    if (!request)
+        request = std::make_unique<Request>();
+    return request;
+}
+
+unsigned SearchWorker::Submit(
+    const Grid& grid,
+    int startCell,
+    int endCell,
+    TieBreak tieBreak,
+    Engine engine,
+    int clusterSize)
+{
+    // a request the worker never picked up is replaced, its walls go out with this one:
+    std::unique_ptr<Request> request = TakeBack();
+
+    // every edit since the last request was reported: send those cells alone, not the whole grid
+    if (sentGrid && grid.version - sentVersion == changedCells.size())
+    {
+        for (int cell : changedCells)
+            request->edits.push_back({ cell, grid.obstacle[cell] != 0 });
+    }
+    else
+    {
+        request->grid = std::make_unique<Grid>(grid);
+        request->edits.clear();
+    }
+    changedCells.clear();
+    sentVersion = grid.version;
+    sentGrid = true;
+
+    unsigned next = ticket.load(std::memory_order_relaxed) + 1;
+    request->ticket = next;
+    request->startCell = startCell;
+    request->endCell = endCell;
+    request->tieBreak = tieBreak;
+    request->engine = engine;
+    request->clusterSize = clusterSize;
+
+    ticket.store(next, std::memory_order_release);
+    pending.store(request.release(), std::memory_order_release);
+    return next;
+}
+
+void SearchWorker::Cancel()
+{
+    ticket.fetch_add(1, std::memory_order_release);
+
+    // the search is dropped, the walls it carried still have to reach the worker:
+    unsent = TakeBack();
+}
+
+void SearchWorker::CellChanged(int cell)
+{
+    if (changedCells.size() < MAX_CHANGED_CELLS)
+        changedCells.push_back(cell);
+    else
+    {
+        changedCells.clear();
+        sentGrid = false;
+    }
+}
+
+bool SearchWorker::Poll(SearchUpdate& update)
+{
+    unsigned current = Ticket();
+    while (updates.TryPop(update))
+    {
+        if (update.ticket == current)
+            return true;
+    }
+    return false;
+}
+
+bool SearchWorker::Stale(unsigned requestTicket) const
+{
+    return stopping.load(std::memory_order_relaxed) ||
+        ticket.load(std::memory_order_acquire) != requestTicket;
+}
+
+bool SearchWorker::Push(SearchUpdate::Kind kind, int cell, float cost)
+{
+    SearchUpdate update;
+    update.kind = kind;
+    update.ticket = progressTicket;
+    update.cell = cell;
+    update.cost = cost;
+    return updates.TryPush(update);
+}
+
+void SearchWorker::Flush()
+{
+    // updates of a cancelled search are no use to anyone:
+    if (sent || Stale(progressTicket))
+    {
+        sent = true;
+        return;
+    }
+
+    // on from where the queue last filled up, expanded cells, then the path once there is one:
+    for (; sentExpanded < expanded.size(); sentExpanded++)
+        if (!Push(SearchUpdate::Kind::Expanded, expanded[sentExpanded]))
+            return;
+    if (!result)
+        return;
+    for (; sentPath < result->path.size(); sentPath++)
+        if (!Push(SearchUpdate::Kind::PathCell, result->path[sentPath]))
+            return;
+    sent = Push(SearchUpdate::Kind::Finished, result->found ? result->path.back() : -1, result->cost);
+}
+
+void SearchWorker::WorkerLoop()
+{
+    std::chrono::microseconds idleSleep = IDLE_SLEEP;
+    while (!stopping.load(std::memory_order_relaxed))
+    {
+        Flush();
+
+        std::unique_ptr<Request> request(pending.exchange(nullptr, std::memory_order_acq_rel));
+        if (request)
+            Run(*request);
+        else
+            std::this_thread::sleep_for(idleSleep);
+
+        // updates still to send keep it polling quickly:
+        if (request || !sent)
+            idleSleep = IDLE_SLEEP;
+        else
+            idleSleep = std::min(idleSleep * 2, MAX_IDLE_SLEEP);
+    }
+}
+
+void SearchWorker::Run(Request& request)
+{
+    // a full copy replaces the worker's, edits since are made to it (and its clusters):
+    if (request.grid)
+    {
+        hierarchy.reset();
+        snapshot = std::move(request.grid);
+    }
+    for (const WallEdit& edit : request.edits)
+    {
+        snapshot->SetObstacle(edit.cell, edit.blocked);
+        if (hierarchy)
+            hierarchy->CellChanged(edit.cell);
+    }
+
+    // a larger context works for smaller grids too, no need to reallocate:
+    const Grid& grid = *snapshot;
+    if (static_cast<int>(context.visited.size()) < grid.Size())
+        context.Resize(grid.Size());
+
+    // whatever the last search hadn't sent yet would only be dropped by Poll():
+    progressTicket = request.ticket;
+    expanded.clear();
+    sentExpanded = 0;
+    result.reset();
+    sentPath = 0;
+    sent = false;
+
+    if (request.engine == Engine::AStar && request.clusterSize == 0)
+    {
+        ResumableSearch search(grid, context);
+        search.Start(request.startCell, request.endCell, request.tieBreak);
+
+        // every cell taken off the open list is recorded, a full queue never holds the search up:
+        search.RecordExpanded(&expanded);
+        while (!search.Step(CHECK_INTERVAL))
+        {
+            Flush();
+            if (Stale(request.ticket))
+                return;
+        }
+        result = search.Result();
+    }
+    else
+    {
+        SearchResult found = request.clusterSize > 0
+            ? Clusters(request.clusterSize).FindPath(context, request.startCell, request.endCell, request.tieBreak)
+            : FindPath(request.engine, grid, context, request.startCell, request.endCell, request.tieBreak);
+        if (Stale(request.ticket))
+            return;
+
+        // every cell it reached, from either end:
+        const SearchContext* backward = request.clusterSize == 0 && request.engine == Engine::Bidirectional
+            ? &context.Backward()
+            : nullptr;
+        for (int cell = 0; cell < grid.Size(); cell++)
+            if (context.IsReached(cell) || (backward && backward->IsReached(cell)))
+                expanded.push_back(cell);
+        result = std::move(found);
+    }
+
+    // the rest goes out from WorkerLoop() as the queue drains:
+    Flush();
+}
+
+Hierarchy& SearchWorker::Clusters(int clusterSize)
+{
+    // built on first use, kept in step with the edits after:
+    if (!hierarchy || hierarchy->ClusterSize() != clusterSize)
+        hierarchy = std::make_unique<Hierarchy>(*snapshot, clusterSize);
+    return *hierarchy;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "AStar.h"
+#include "Engine.h"
+#include "Grid.h"
+#include "SearchContext.h"
+#include "SpscQueue.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
+class Hierarchy;
+
+// progress of a background search, in the order it happened:
+struct SearchUpdate
+{
+    enum class Kind : std::uint8_t
+    {
+        Expanded,   // cell was taken off the open list
+        PathCell,   // next cell of the path, start -> end
+        Finished    // cell = end cell if found, -1 if not, cost = path cost
+    };
+
+    Kind kind = Kind::Expanded;
+    unsigned ticket = 0;
+    int cell = -1;
+    float cost = 0.0f;
+};
+
+/* Searches on a worker thread, with any engine or HPA*:
+ * the worker searches a copy of the grid of its own. the first Submit()
+ * hands over a full copy, later ones only the walls changed since, as
+ * reported through CellChanged() after each edit (edits it wasn't told
+ * about, or another grid, send a full copy again). the worker streams
+ * expanded cells, then the path, back through a lock-free single
+ * producer / single consumer queue for the caller to Poll()
+ * once per frame. neither side ever waits on the other: requests are
+ * swapped in through an atomic pointer, and the worker searches on
+ * while the queue is full. what the queue can't take yet is read from
+ * the search's own record of the cells it expanded (one int per cell
+ * at most) and its path, sent on from where the caller got to as room
+ * is made, so memory stays bounded however slowly the queue is drained.
+ *
+ * plain A* reports cells as it expands them. the other engines can't
+ * stop part way, so they run whole and then report every cell they
+ * reached, HPA* over clusters the worker keeps for its own copy.
+ *
+ * a new Submit() or Cancel() bumps the ticket, the worker drops an
+ * A* search within a few hundred expansions (any other engine once
+ * it's done) and Poll() never returns updates of an older ticket.
+ * Submit(), Cancel() and Poll() belong to one thread.
+ */
+class SearchWorker
+{
+public:
+    SearchWorker();
+    ~SearchWorker();
+
+    SearchWorker(const SearchWorker&) = delete;
+    SearchWorker& operator=(const SearchWorker&) = delete;
+
+    /* replaces any search in flight, returns its ticket. clusterSize > 0
+     * runs HPA* with clusters that size instead of engine.
+     */
+    unsigned Submit(
+        const Grid& grid,
+        int startCell,
+        int endCell,
+        TieBreak tieBreak = TieBreak::LastIn,
+        Engine engine = Engine::AStar,
+        int clusterSize = 0);
+    void Cancel();
+
+    // call after each wall edit of the grid given to Submit():
+    void CellChanged(int cell);
+
+    // next update of the current ticket, false once none are waiting:
+    bool Poll(SearchUpdate& update);
+
+    unsigned Ticket() const { return ticket.load(std::memory_order_relaxed); }
+
+private:
+    struct WallEdit
+    {
+        int cell;
+        bool blocked;
+    };
+
+    struct Request
+    {
+        unsigned ticket = 0;
+        std::unique_ptr<Grid> grid;         // full copy, nullptr = edit the worker's copy
+        std::vector<WallEdit> edits;        // applied in order, after grid
+        int startCell = -1;
+        int endCell = -1;
+        TieBreak tieBreak = TieBreak::LastIn;
+        Engine engine = Engine::AStar;
+        int clusterSize = 0;
+    };
+
+    // the request the worker hasn't picked up yet, or any walls a Cancel() took back, or an empty one:
+    std::unique_ptr<Request> TakeBack();
+
+    void WorkerLoop();
+    void Run(Request& request);
+    Hierarchy& Clusters(int clusterSize);
+
+    bool Stale(unsigned requestTicket) const;
+    bool Push(SearchUpdate::Kind kind, int cell, float cost = 0.0f);
+    void Flush();
+
+    // caller's thread only, edits since the last Submit() + the version the worker's copy is heading for:
+    std::vector<int> changedCells;
+    std::uint64_t sentVersion = 0;
+    bool sentGrid = false;
+    std::unique_ptr<Request> unsent;     // walls of a request cancelled before the worker took it
+
+    std::atomic<unsigned> ticket{ 0 };
+    std::atomic<Request*> pending{ nullptr };
+    std::atomic<bool> stopping{ false };
+
+    SpscQueue<SearchUpdate> updates;
+
+    // worker thread only, its copy of the grid (+ clusters over it), the latest search + how much of it is in the queue so far:
+    std::unique_ptr<Grid> snapshot;
+    std::unique_ptr<Hierarchy> hierarchy;
+    SearchContext context;
+    unsigned progressTicket = 0;
+    std::vector<int> expanded;           // every cell expanded so far, in order
+    std::size_t sentExpanded = 0;
+    std::optional<SearchResult> result;  // once the search has finished
+    std::size_t sentPath = 0;
+    bool sent = true;                    // Finished is in the queue, or the ticket went stale
+
+    std::thread worker;
+};
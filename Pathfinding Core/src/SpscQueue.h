@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+/* Bounded lock-free queue for exactly one producer thread and one
+ * consumer thread. neither side ever waits: TryPush() fails when the
+ * queue is full, TryPop() when it's empty. capacity is rounded up to
+ * a power of two.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(std::size_t capacity)
+    {
+        std::size_t size = 1;
+        while (size < capacity)
+            size *= 2;
+        slots.resize(size);
+        mask = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // producer only:
+    bool TryPush(const T& value)
+    {
+        std::size_t tail = this->tail.load(std::memory_order_relaxed);
+        if (tail - head.load(std::memory_order_acquire) > mask)
+            return false;
+
+        slots[tail & mask] = value;
+        this->tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only:
+    bool TryPop(T& value)
+    {
+        std::size_t head = this->head.load(std::memory_order_relaxed);
+        if (head == tail.load(std::memory_order_acquire))
+            return false;
+
+        value = slots[head & mask];
+        this->head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::vector<T> slots;
+    std::size_t mask = 0;
+
+    // each index on its own cache line, the two threads never share one:
+    alignas(64) std::atomic<std::size_t> head{ 0 };     // next slot to pop
+    alignas(64) std::atomic<std::size_t> tail{ 0 };     // next slot to push
+};